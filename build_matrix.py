@@ -0,0 +1,163 @@
+"""Build matrix driver: builds the CMake build-matrix targets (-O2, LTO,
+-march=native, PGO) with every available compiler, runs each build with the
+same benchmark arguments and writes one table in the
+performance_comparison_detailed.csv format (Source, Version, Average_ns,
+Median_ns, P95_ns, P99_ns, Speedup vs Original within the same build).
+
+The summary printed at the end splits each variant's speedup into the part
+from the algorithm (Original -> variant, both at -O2) and the part from the
+build (variant at -O2 -> variant in that build).
+
+    python3 build_matrix.py
+    python3 build_matrix.py --compilers g++ --only 'Original,V4*,V6*' -- --test-size 2000000
+"""
+import argparse
+import csv
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+COMPILERS = {
+    'g++': 'G++',
+    'clang++': 'Clang',
+}
+
+# (target, label); iso_week_pgo_generate is built for training only.
+BUILDS = [
+    ('iso_week_o2', 'O2'),
+    ('iso_week_lto', 'LTO'),
+    ('iso_week_native', 'native'),
+    ('iso_week_pgo_use', 'PGO'),
+]
+
+DEFAULT_RUN_ARGS = ['--timing=batch', '--test-size', '5000000', '--iterations', '50000000', '--no-perf', '--quiet']
+METRICS = ['Average_ns', 'Median_ns', 'P95_ns', 'P99_ns']
+
+
+def run(cmd, **kwargs):
+    print('+ ' + ' '.join(cmd), flush=True)
+    return subprocess.run(cmd, check=True, **kwargs)
+
+
+def build_compiler(source_dir, build_dir, compiler, jobs):
+    """Configures a fresh tree for one compiler and builds every matrix target.
+    Returns the {label: binary path} of the builds that exist."""
+    shutil.rmtree(build_dir, ignore_errors=True)
+    run(['cmake', '-S', source_dir, '-B', build_dir, '-DCMAKE_CXX_COMPILER=' + compiler])
+
+    built = {}
+    for target, label in BUILDS:
+        if target == 'iso_week_pgo_use':
+            try:
+                run(['cmake', '--build', build_dir, '-j', str(jobs), '--target', 'iso_week_pgo_generate'])
+                run(['cmake', '--build', build_dir, '--target', 'iso_week_pgo_train'])
+            except subprocess.CalledProcessError:
+                print(f'  PGO training failed for {compiler}; skipping PGO', file=sys.stderr)
+                continue
+        try:
+            run(['cmake', '--build', build_dir, '-j', str(jobs), '--target', target])
+        except subprocess.CalledProcessError:
+            print(f'  {target} did not build with {compiler}; skipping', file=sys.stderr)
+            continue
+        built[label] = os.path.join(build_dir, target)
+    return built
+
+
+def run_benchmark(binary, args):
+    """Runs one build in a scratch directory and returns its benchmark_analysis.csv rows."""
+    with tempfile.TemporaryDirectory() as work:
+        run([os.path.abspath(binary)] + args, cwd=work, stdout=subprocess.DEVNULL)
+        with open(os.path.join(work, 'benchmark_analysis.csv'), newline='', encoding='utf-8') as f:
+            return list(csv.DictReader(f))
+
+
+def to_rows(name, build, rows):
+    """benchmark_analysis.csv rows -> performance_comparison_detailed.csv rows.
+    Runs with several distributions get one Source per distribution. The extra
+    'Reference' key names the O2 source of the same compiler for the summary."""
+    distributions = sorted({r.get('Distribution', '') for r in rows})
+    out = []
+    for distribution in distributions:
+        subset = [r for r in rows if r.get('Distribution', '') == distribution]
+        suffix = '' if len(distributions) == 1 else f', {distribution}'
+        baseline = next((float(r['Average_ns']) for r in subset if r['Version'].strip('_') == 'Original'),
+                        float(subset[0]['Average_ns']))
+        for r in subset:
+            average = float(r['Average_ns'])
+            out.append({
+                'Source': f'{name} ({build}{suffix})',
+                'Reference': f'{name} (O2{suffix})',
+                'Version': r['Version'].strip('_'),
+                **{m: float(r[m]) for m in METRICS},
+                'Speedup': baseline / average if average > 0 else 0,
+            })
+    return out
+
+
+def print_summary(rows):
+    """Algorithm speedup (Original at -O2 -> variant at -O2) versus build
+    speedup (variant at -O2 -> variant in each other build)."""
+    by_source = {}
+    references = {}
+    for r in rows:
+        by_source.setdefault(r['Source'], {})[r['Version']] = r['Average_ns']
+        references[r['Source']] = r['Reference']
+
+    print('\n=== SPEEDUP: ALGORITHM vs BUILD ===')
+    print(f'{"Source":<22}{"Version":<24}{"Average_ns":>11}{"Algorithm":>11}{"Build":>9}{"Total":>9}')
+    for source, versions in by_source.items():
+        reference = by_source.get(references[source], {})
+        original = reference.get('Original')
+        for version, average in versions.items():
+            at_o2 = reference.get(version)
+            if not original or not at_o2 or average <= 0:
+                continue
+            algorithm = original / at_o2
+            build = at_o2 / average
+            print(f'{source:<22}{version:<24}{average:>11.2f}{algorithm:>10.2f}x{build:>8.2f}x{algorithm * build:>8.2f}x')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--compilers', default=','.join(COMPILERS),
+                        help='comma-separated C++ compilers; missing ones are skipped (default: g++,clang++)')
+    parser.add_argument('--build-dir', default='_matrix', help='parent of the per-compiler build trees')
+    parser.add_argument('--output', default='performance_comparison_matrix.csv', help='comparison table to write')
+    parser.add_argument('--only', help="variant globs passed to every run as --only (e.g. 'Original,V4*')")
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1)
+    parser.add_argument('run_args', nargs='*', help='benchmark arguments after --, replacing the defaults')
+    args = parser.parse_args()
+
+    source_dir = os.path.dirname(os.path.abspath(__file__))
+    run_args = args.run_args or list(DEFAULT_RUN_ARGS)
+    if args.only:
+        run_args += ['--only', args.only]
+
+    rows = []
+    for compiler in args.compilers.split(','):
+        if not shutil.which(compiler):
+            print(f'{compiler} not found; skipping', file=sys.stderr)
+            continue
+        name = COMPILERS.get(compiler, compiler)
+        build_dir = os.path.abspath(os.path.join(args.build_dir, compiler.replace('+', 'x')))
+        for label, binary in build_compiler(source_dir, build_dir, compiler, args.jobs).items():
+            rows += to_rows(name, label, run_benchmark(binary, run_args))
+
+    if not rows:
+        print('No results to process.')
+        return 1
+
+    with open(args.output, 'w', newline='', encoding='utf-8') as f:
+        writer = csv.DictWriter(f, fieldnames=['Source', 'Version'] + METRICS + ['Speedup'],
+                                extrasaction='ignore')
+        writer.writeheader()
+        writer.writerows(rows)
+    print_summary(rows)
+    print(f'\nWrote {args.output} ({len(rows)} rows)')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
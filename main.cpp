@@ -1,17 +1,60 @@
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <chrono>
 #include <vector>
 #include <random>
 #include <ctime>
 #include <iomanip>
 #include <cstring>
+#include <cstdio>
 #include <algorithm>
 #include <sstream>
+#include <span>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <limits>
+#include <thread>
+#include <latch>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <tuple>
+#include <numeric>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ISO_WEEK_X86_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 
 #ifdef __linux__
 #include <sys/resource.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/auxv.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 #endif
 
 #ifdef _WIN32
@@ -29,7 +72,7 @@ struct BenchmarkConfig {
 #endif
 #ifdef _WIN32
     size_t testDataSize = 1000000;
-    size_t iterationCount = 1000000;
+    size_t iterationCount = 1000000000;         // Total calls (batch mode: 1000 per sample)
 #endif
 
     int minYear = 1800;                          // Minimum year
@@ -37,8 +80,163 @@ struct BenchmarkConfig {
     bool includeEdgeCases = true;               // Include boundary cases
     bool verboseOutput = true;                  // Detailed output
     bool trackMemory = true;                    // Memory tracking
+
+    // How per-call kernels are timed:
+    //   PerCall - two clock reads around every call
+    //   Batch   - one clock read pair around timingBatchSize calls
+    //   Rdtsc   - rdtsc/rdtscp around every call, converted with the calibrated TSC rate
+    // The measured cost of the empty timing loop is subtracted from every sample.
+    enum class TimingMode { PerCall, Batch, Rdtsc };
+#ifdef _WIN32
+    TimingMode timingMode = TimingMode::Batch;   // Timer resolution is too coarse for per-call
+#else
+    TimingMode timingMode = TimingMode::PerCall;
+#endif
+    size_t timingBatchSize = 1000;
+
+    // Where timing samples go:
+    //   Exact     - every sample is stored and sorted (8 bytes per sample)
+    //   Histogram - constant-memory log-linear histogram (see LogLinearHistogram)
+    //   Auto      - Exact up to autoHistogramSamples samples, Histogram above
+    enum class StatsBackend { Auto, Exact, Histogram };
+    StatsBackend statsBackend = StatsBackend::Auto;
+    size_t autoHistogramSamples = 100000000;
+
+    // Worker threads per benchmark. With more than one, the corpus is split
+    // into contiguous shards, each worker is pinned to its own CPU, and every
+    // variant is also run once on a single pinned worker for the scaling
+    // efficiency reference.
+    size_t threadCount = 1;
+
+    // Threads used to generate the test corpus (0 = all hardware threads).
+    // The generated data does not depend on this value.
+    size_t generatorThreads = 0;
+
+    // --verify-exhaustive: check every (year, yday) of this range for every
+    // variant instead of benchmarking. Runs on threadCount threads when
+    // --threads is given, otherwise on all hardware threads.
+    bool verifyExhaustive = false;
+    int verifyMinYear = 1;
+    int verifyMaxYear = 9999;
+
+    // Comma-separated variant name globs ('*' wildcard) for --only/--exclude.
+    std::string onlyVariants;
+    std::string excludeVariants;
+
+    // Wrap every timed run in a perf_event_open counter group (Linux).
+    bool perfCounters = true;
+
+    // Independent trials (--trials). With more than one, each trial runs the
+    // selected variants in a new random order drawn from trialSeed. Trials
+    // whose median is an outlier are dropped, and the reported numbers come
+    // with bootstrap confidence intervals over the remaining trials.
+    size_t trialCount = 1;
+    uint64_t trialSeed = 1;
+    double confidenceLevel = 0.95;
+
+    // --compare: an earlier benchmark_analysis.csv. A variant regresses when
+    // its median confidence interval lies entirely above the baseline's and
+    // its median is more than regressionThreshold slower.
+    std::string compareBaselinePath;
+    double regressionThreshold = 0.02;
+
+    // Input patterns (--distribution); each listed distribution gets its own
+    // corpus and a full run, and the CSV is keyed by it.
+    //   Uniform     - uniform year and day (the original generator)
+    //   Sorted      - consecutive days from minYear, wrapping after maxYear
+    //   Recent      - uniform over the RECENT_WINDOW_DAYS days up to today (UTC)
+    //   Boundary    - uniform year, first and last 7 days only (1-7, 359/360-365/366)
+    //   Alternating - dates that fall in the previous or next ISO year (chosen
+    //                 at random) alternating with mid-year dates
+    enum class Distribution { Uniform, Sorted, Recent, Boundary, Alternating };
+    std::vector<Distribution> distributions = {Distribution::Uniform};
+    Distribution distribution = Distribution::Uniform;   // The one being generated
+
+    // --generate-file / --convert-file: raw little-endian columns of int32
+    // epoch days or int64 epoch seconds, converted to one week byte per record.
+    enum class FileFormat { EpochDays, EpochSeconds };
+    FileFormat fileFormat = FileFormat::EpochDays;
+    std::string generateFilePath;
+    size_t generateFileRecords = 0;
+    std::string convertInputPath;
+    std::string convertOutputPath;
+
+    // --sweep-working-set: time conversions over working sets from 4 KB up to
+    // sweepMaxBytes, for the array-of-structs record and the compact columns,
+    // then exit.
+    bool sweepWorkingSet = false;
+    size_t sweepMaxBytes = size_t{4} << 30;
+
+    // --aggregate: group aggregateRows generated rows by ISO week (count, sum,
+    // min, max of a value column) with the dense per-thread histograms and
+    // with convert + std::unordered_map, then exit. --aggregate-file counts
+    // the rows of a column file per week instead.
+    size_t aggregateRows = 0;
+    std::string aggregateInputPath;
+
+    // --pipeline: run pipelineRows generated "YYYY-MM-DD" lines through
+    // parse -> convert -> aggregate stages connected by SPSC rings of
+    // pipelineQueueDepth batches of pipelineBatchRecords records, report
+    // per-stage metrics, then exit.
+    size_t pipelineRows = 0;
+    std::array<size_t, 3> pipelineThreads = {1, 1, 1};     // Parse, convert, aggregate
+    size_t pipelineBatchRecords = 16384;
+    size_t pipelineQueueDepth = 8;
+
+    // --serve / --load: conversion service on a Unix domain socket and its
+    // load generator; with both on one path the server runs on a thread of
+    // this process. Each load connection keeps loadDepth requests of
+    // loadBatchRecords records in flight until loadRequests have returned.
+    // The listed loadOps run back to back against the same server.
+    enum class ServiceRequest { DaysToWeeks, DaysToIsoWeekDates, SecondsToWeeks };
+    std::string servePath;
+    std::string loadPath;
+    std::vector<ServiceRequest> loadOps = {ServiceRequest::DaysToWeeks};
+    size_t loadConnections = 4;
+    size_t loadRequests = 10000;
+    size_t loadBatchRecords = 1024;
+    size_t loadDepth = 1;
+
+    // --tail-threshold: record every sample above tailThresholdNs with the
+    // faults, context switches and CPU migrations of its window of
+    // tailWindowSamples samples, and attribute it to one of them
+    // (tail_timeline.csv). 0 = off.
+    double tailThresholdNs = 0.0;
+    size_t tailWindowSamples = 1024;
+};
+
+inline const char* timingModeName(BenchmarkConfig::TimingMode mode) {
+    switch (mode) {
+    case BenchmarkConfig::TimingMode::Batch: return "batch";
+    case BenchmarkConfig::TimingMode::Rdtsc: return "rdtsc";
+    default: return "per-call";
+    }
+}
+
+constexpr BenchmarkConfig::Distribution ALL_DISTRIBUTIONS[] = {
+    BenchmarkConfig::Distribution::Uniform, BenchmarkConfig::Distribution::Sorted,
+    BenchmarkConfig::Distribution::Recent, BenchmarkConfig::Distribution::Boundary,
+    BenchmarkConfig::Distribution::Alternating,
 };
 
+inline const char* distributionName(BenchmarkConfig::Distribution distribution) {
+    switch (distribution) {
+    case BenchmarkConfig::Distribution::Sorted: return "sorted";
+    case BenchmarkConfig::Distribution::Recent: return "recent";
+    case BenchmarkConfig::Distribution::Boundary: return "boundary";
+    case BenchmarkConfig::Distribution::Alternating: return "alternating";
+    default: return "uniform";
+    }
+}
+
+inline const char* fileFormatName(BenchmarkConfig::FileFormat format) {
+    return format == BenchmarkConfig::FileFormat::EpochSeconds ? "seconds" : "days";
+}
+
+inline size_t fileRecordBytes(BenchmarkConfig::FileFormat format) {
+    return format == BenchmarkConfig::FileFormat::EpochSeconds ? sizeof(int64_t) : sizeof(int32_t);
+}
+
 // ============================================================================
 // MEMORY TRACKING
 // ============================================================================
@@ -74,12 +272,443 @@ struct MemoryStats {
     }
 };
 
+// ============================================================================
+// CYCLE COUNTER
+// ============================================================================
+// Serialized TSC reads (lfence; rdtsc ... rdtscp; lfence) so the measured
+// region neither starts early nor leaks into the next sample. The TSC rate is
+// calibrated once against steady_clock.
+struct CycleTimer {
+    static bool available() {
+#ifdef ISO_WEEK_X86_SIMD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static inline uint64_t begin() {
+#ifdef ISO_WEEK_X86_SIMD
+        _mm_lfence();
+        const uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#else
+        return 0;
+#endif
+    }
+
+    static inline uint64_t end() {
+#ifdef ISO_WEEK_X86_SIMD
+        unsigned int aux;
+        const uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#else
+        return 0;
+#endif
+    }
+
+    static double nsPerTick() {
+        static const double value = calibrate();
+        return value;
+    }
+
+private:
+    static double calibrate() {
+        if (!available()) {
+            return 1.0;
+        }
+        using clock = std::chrono::steady_clock;
+        const auto wallStart = clock::now();
+        const uint64_t tscStart = begin();
+        while (clock::now() - wallStart < std::chrono::milliseconds(50)) {
+        }
+        const uint64_t tscEnd = end();
+        const double elapsedNs = std::chrono::duration<double, std::nano>(clock::now() - wallStart).count();
+        return elapsedNs / static_cast<double>(tscEnd - tscStart);
+    }
+};
+
+// ============================================================================
+// CPU FREQUENCY
+// ============================================================================
+// Governor, turbo state and clock of the machine, read from cpufreq in sysfs
+// (current clock falls back to /proc/cpuinfo). Fields stay empty/zero/-1
+// where the platform does not expose them (containers, VMs, Windows).
+struct CpuFrequencyInfo {
+    std::string governor;               // scaling_governor of CPU 0
+    double currentMHz = 0.0;            // Mean current clock over all CPUs
+    double minMHz = 0.0;                // cpufreq limits of CPU 0
+    double maxMHz = 0.0;
+    int turbo = -1;                     // 1 on, 0 off, -1 unknown
+
+    void capture() {
+#ifdef __linux__
+        const std::string cpufreq = "/sys/devices/system/cpu/cpu0/cpufreq/";
+        governor = readLine(cpufreq + "scaling_governor");
+        minMHz = readNumber(cpufreq + "scaling_min_freq") / 1000.0;
+        maxMHz = readNumber(cpufreq + "scaling_max_freq") / 1000.0;
+
+        const std::string noTurbo = readLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        const std::string boost = readLine("/sys/devices/system/cpu/cpufreq/boost");
+        if (!noTurbo.empty()) {
+            turbo = noTurbo == "0" ? 1 : 0;
+        } else if (!boost.empty()) {
+            turbo = boost == "1" ? 1 : 0;
+        }
+#endif
+        currentMHz = readCurrentMHz();
+    }
+
+    // Mean clock over all CPUs right now (0: unknown).
+    static double readCurrentMHz() {
+        double sum = 0.0;
+        size_t cpus = 0;
+#ifdef __linux__
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            const double khz = readNumber("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+            if (khz > 0.0) {
+                sum += khz / 1000.0;
+                ++cpus;
+            }
+        }
+        if (cpus == 0) {
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line)) {
+                if (line.rfind("cpu MHz", 0) == 0) {
+                    const size_t colon = line.find(':');
+                    if (colon != std::string::npos) {
+                        sum += std::strtod(line.c_str() + colon + 1, nullptr);
+                        ++cpus;
+                    }
+                }
+            }
+        }
+#endif
+        return cpus ? sum / cpus : 0.0;
+    }
+
+    // Settings that make timings drift between runs.
+    std::vector<std::string> warnings() const {
+        std::vector<std::string> result;
+        if (!governor.empty() && governor != "performance") {
+            result.push_back("governor '" + governor + "' changes the clock with load; 'performance' gives stable numbers");
+        }
+        if (turbo == 1) {
+            result.push_back("turbo is on; the clock depends on temperature and the number of busy cores");
+        }
+        return result;
+    }
+
+    std::string describe() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(0);
+        if (currentMHz > 0.0) {
+            out << currentMHz << " MHz";
+        } else {
+            out << "clock unknown";
+        }
+        if (maxMHz > 0.0) {
+            out << " (limits " << minMHz << "-" << maxMHz << " MHz)";
+        }
+        out << ", governor " << (governor.empty() ? "unknown" : governor)
+            << ", turbo " << (turbo < 0 ? "unknown" : turbo ? "on" : "off");
+        return out.str();
+    }
+
+private:
+    static std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static double readNumber(const std::string& path) {
+        const std::string line = readLine(path);
+        return line.empty() ? 0.0 : std::strtod(line.c_str(), nullptr);
+    }
+};
+
+// ============================================================================
+// HARDWARE PERFORMANCE COUNTERS (Linux perf_event_open)
+// ============================================================================
+// One counter group per measuring thread, user space only, read with
+// PERF_FORMAT_GROUP so every event covers the same interval. Events the PMU
+// does not offer are left out of the group. When perf_event_open is refused
+// (containers, perf_event_paranoid, VMs without a virtual PMU) the counts are
+// reported as unavailable and the benchmark runs unchanged.
+struct PerfCounts {
+    enum Event { Cycles, Instructions, Branches, BranchMisses, L1dMisses, Uops, EventCount };
+
+    std::array<uint64_t, EventCount> value{};
+    std::array<bool, EventCount> present{};
+    bool multiplexed = false;               // Values were scaled by time_enabled / time_running
+
+    bool has(Event e) const noexcept { return present[e]; }
+    bool valid() const noexcept { return present[Cycles]; }
+
+    void merge(const PerfCounts& other) noexcept {
+        for (int e = 0; e < EventCount; ++e) {
+            if (other.present[e]) {
+                value[e] += other.value[e];
+                present[e] = true;
+            }
+        }
+        multiplexed |= other.multiplexed;
+    }
+
+    double perConversion(Event e, size_t conversions) const noexcept {
+        return static_cast<double>(value[e]) / static_cast<double>(std::max<size_t>(1, conversions));
+    }
+    double ipc() const noexcept {
+        return static_cast<double>(value[Instructions]) / static_cast<double>(std::max<uint64_t>(1, value[Cycles]));
+    }
+    double branchMissRate() const noexcept {
+        return static_cast<double>(value[BranchMisses]) / static_cast<double>(std::max<uint64_t>(1, value[Branches]));
+    }
+
+    static const char* eventName(int e) noexcept {
+        static const char* const names[EventCount] = {"cycles", "instructions", "branches", "branch-misses", "L1d-misses", "uops"};
+        return names[e];
+    }
+};
+
+class PerfCounterGroup {
+public:
+    explicit PerfCounterGroup(bool enabled) {
+        fds.fill(-1);
+#ifdef __linux__
+        if (enabled && !openGroup(true)) {
+            openGroup(false);               // Core events only if the full group cannot be scheduled
+        }
+#else
+        (void)enabled;
+#endif
+    }
+
+    ~PerfCounterGroup() { close(); }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool isOpen() const noexcept { return fds[PerfCounts::Cycles] >= 0; }
+
+    void start() noexcept {
+#ifdef __linux__
+        if (isOpen()) {
+            ioctl(fds[PerfCounts::Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[PerfCounts::Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    PerfCounts stop() noexcept {
+        PerfCounts counts;
+#ifdef __linux__
+        if (!isOpen()) {
+            return counts;
+        }
+        ioctl(fds[PerfCounts::Cycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // nr, time_enabled, time_running, then one value per group member in open order
+        uint64_t buffer[3 + PerfCounts::EventCount] = {};
+        if (::read(fds[PerfCounts::Cycles], buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(uint64_t))
+            || buffer[2] == 0) {
+            return counts;
+        }
+        const double scale = static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+        counts.multiplexed = buffer[2] < buffer[1];
+        for (int e = 0, slot = 0; e < PerfCounts::EventCount; ++e) {
+            if (fds[e] >= 0 && static_cast<uint64_t>(slot) < buffer[0]) {
+                counts.value[e] = static_cast<uint64_t>(static_cast<double>(buffer[3 + slot++]) * scale);
+                counts.present[e] = true;
+            }
+        }
+#endif
+        return counts;
+    }
+
+    // Which events this machine offers, or why there are none; printed once at start-up.
+    static std::string describeAvailability(bool enabled) {
+        if (!enabled) {
+            return "disabled (--no-perf)";
+        }
+#ifdef __linux__
+        PerfCounterGroup probe(true);
+        if (!probe.isOpen()) {
+            std::string reason = "unavailable (perf_event_open: " + std::string(std::strerror(probe.openErrno));
+            std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+            int level;
+            if (paranoid >> level) {
+                reason += ", perf_event_paranoid=" + std::to_string(level);
+            }
+            return reason + ")";
+        }
+        std::string events;
+        for (int e = 0; e < PerfCounts::EventCount; ++e) {
+            if (probe.fds[e] >= 0) {
+                events += (events.empty() ? "" : " ") + std::string(PerfCounts::eventName(e));
+            }
+        }
+        return events;
+#else
+        return "unavailable (perf_event_open is Linux-only)";
+#endif
+    }
+
+private:
+    std::array<int, PerfCounts::EventCount> fds;
+    int openErrno = 0;
+
+#ifdef __linux__
+    static bool eventConfig(int e, uint32_t& type, uint64_t& config) noexcept {
+        switch (e) {
+        case PerfCounts::Cycles:       type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_CPU_CYCLES; return true;
+        case PerfCounts::Instructions: type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_INSTRUCTIONS; return true;
+        case PerfCounts::Branches:     type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS; return true;
+        case PerfCounts::BranchMisses: type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_BRANCH_MISSES; return true;
+        case PerfCounts::L1dMisses:
+            type = PERF_TYPE_HW_CACHE;
+            config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            return true;
+        case PerfCounts::Uops:
+            // No generic event: raw UOPS_RETIRED.SLOTS (Intel, event 0xC2 umask 0x02)
+            // or Retired Uops (AMD, PMCx0C1).
+#if defined(ISO_WEEK_X86_SIMD) && defined(__GNUC__)
+            type = PERF_TYPE_RAW;
+            if (__builtin_cpu_is("intel")) { config = 0x02C2; return true; }
+            if (__builtin_cpu_is("amd")) { config = 0x00C1; return true; }
+#endif
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    bool openGroup(bool withOptional) {
+        close();
+        for (int e = 0; e < PerfCounts::EventCount; ++e) {
+            const bool optional = e == PerfCounts::L1dMisses || e == PerfCounts::Uops;
+            uint32_t type;
+            uint64_t config;
+            if ((optional && !withOptional) || !eventConfig(e, type, config)) {
+                continue;
+            }
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = e == PerfCounts::Cycles;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const int leader = fds[PerfCounts::Cycles];
+            fds[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fds[e] < 0 && e == PerfCounts::Cycles) {
+                openErrno = errno;
+                return true;                // Nothing to fall back to
+            }
+        }
+        // A group the PMU cannot schedule as a whole never runs.
+        start();
+        volatile int spin = 0;
+        for (int i = 0; i < 1000; ++i) {
+            spin = spin + i;
+        }
+        const PerfCounts probe = stop();
+        if (probe.valid() || !withOptional) {
+            return true;
+        }
+        close();
+        return false;
+    }
+#endif
+
+    void close() noexcept {
+#ifdef __linux__
+        for (int& fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+#endif
+    }
+};
+
+// ============================================================================
+// CODE SIZE
+// ============================================================================
+// Machine code size of a function, read from the running executable's ELF
+// symbol table (st_size of the function symbol at that address). Returns 0
+// when unknown: stripped binaries, non-ELF platforms, or an address that is
+// not the start of a symbol (e.g. a function that was only inlined).
+class CodeSizeTable {
+public:
+    static size_t bytesAt(const void* function) {
+        static const CodeSizeTable table;
+        const uintptr_t address = reinterpret_cast<uintptr_t>(function);
+        const auto it = std::lower_bound(table.symbols.begin(), table.symbols.end(), std::make_pair(address, size_t(0)));
+        return it != table.symbols.end() && it->first == address ? it->second : 0;
+    }
+
+private:
+    std::vector<std::pair<uintptr_t, size_t>> symbols;     // Runtime address, size; sorted
+
+    CodeSizeTable() {
+#ifdef __linux__
+        std::ifstream file("/proc/self/exe", std::ios::binary);
+        const std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        Elf64_Ehdr header;
+        if (image.size() < sizeof(header)) {
+            return;
+        }
+        std::memcpy(&header, image.data(), sizeof(header));
+        if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64
+            || header.e_shoff + size_t(header.e_shnum) * sizeof(Elf64_Shdr) > image.size()
+            || header.e_phoff + size_t(header.e_phnum) * sizeof(Elf64_Phdr) > image.size()) {
+            return;
+        }
+
+        // Load bias: where the program headers are mapped minus where the file says they are.
+        uintptr_t phdrAddress = header.e_phoff;
+        for (size_t i = 0; i < header.e_phnum; ++i) {
+            Elf64_Phdr ph;
+            std::memcpy(&ph, image.data() + header.e_phoff + i * sizeof(ph), sizeof(ph));
+            if (ph.p_type == PT_PHDR) {
+                phdrAddress = ph.p_vaddr;
+            }
+        }
+        const uintptr_t bias = getauxval(AT_PHDR) - phdrAddress;
+
+        for (size_t i = 0; i < header.e_shnum; ++i) {
+            Elf64_Shdr section;
+            std::memcpy(&section, image.data() + header.e_shoff + i * sizeof(section), sizeof(section));
+            if (section.sh_type != SHT_SYMTAB || section.sh_offset + section.sh_size > image.size()) {
+                continue;
+            }
+            for (size_t offset = 0; offset + sizeof(Elf64_Sym) <= section.sh_size; offset += sizeof(Elf64_Sym)) {
+                Elf64_Sym symbol;
+                std::memcpy(&symbol, image.data() + section.sh_offset + offset, sizeof(symbol));
+                if (ELF64_ST_TYPE(symbol.st_info) == STT_FUNC && symbol.st_size > 0 && symbol.st_value != 0) {
+                    symbols.emplace_back(bias + symbol.st_value, symbol.st_size);
+                }
+            }
+        }
+        std::sort(symbols.begin(), symbols.end());
+#endif
+    }
+};
+
 // ============================================================================
 // ISO 8601 WEEK DATE CONVERSION FUNCTIONS
 // ============================================================================
 
 // Original version
-int convertGregorianDateToWeekDate_Original(const struct tm& times) noexcept
+constexpr int convertGregorianDateToWeekDate_Original(const struct tm& times) noexcept
 {
     const int y = times.tm_year + 1900;
     const int dayOfYearNumber = times.tm_yday + 1;
@@ -124,7 +753,7 @@ int convertGregorianDateToWeekDate_Original(const struct tm& times) noexcept
 }
 
 // V1: Early Return
-int convertGregorianDateToWeekDate_V1(const struct tm& times) noexcept
+constexpr int convertGregorianDateToWeekDate_V1(const struct tm& times) noexcept
 {
     const int y = times.tm_year + 1900;
     const int dayOfYear = times.tm_yday + 1;
@@ -158,7 +787,7 @@ int convertGregorianDateToWeekDate_V1(const struct tm& times) noexcept
 }
 
 // V2: Bitwise Operations
-int convertGregorianDateToWeekDate_V2(const struct tm& times) noexcept
+constexpr int convertGregorianDateToWeekDate_V2(const struct tm& times) noexcept
 {
     const int y = times.tm_year + 1900;
     const int dayOfYear = times.tm_yday + 1;
@@ -191,7 +820,7 @@ int convertGregorianDateToWeekDate_V2(const struct tm& times) noexcept
 }
 
 // V3: Calculation Splitting
-int convertGregorianDateToWeekDate_V3(const struct tm& times) noexcept
+constexpr int convertGregorianDateToWeekDate_V3(const struct tm& times) noexcept
 {
     const int y = times.tm_year + 1900;
     const int dayOfYear = times.tm_yday + 1;
@@ -225,224 +854,6776 @@ int convertGregorianDateToWeekDate_V3(const struct tm& times) noexcept
     return weekNumber;
 }
 
-// ============================================================================
-// TEST DATA STRUCTURES
-// ============================================================================
-struct TestCase {
-    struct tm timeStruct;
-    int year;
-    int dayOfYear;
-    std::string description;
-};
+// V4: Mathematical Masks (branchless)
+constexpr int weekNumber_V4(int y, int dayOfYear) noexcept
+{
+    const int y_1 = y - 1;
+    const int jan1Weekday = 1 + ((y_1 + (y_1 / 4) - (y_1 / 100) + (y_1 / 400)) % 7);
+    const int weekday = 1 + ((dayOfYear + jan1Weekday - 2) % 7);
+    const int isPrevYear = (dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4);
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 % 100) != 0) | ((y_1 % 400) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    const int prevYearWeek = 52 + prevIs53;
+    const int isLeap = ((y & 3) == 0) & (((y % 100) != 0) | ((y % 400) == 0));
+    const int daysInYear = 365 + isLeap;
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    const int currYearWeek = (j / 7) - (jan1Weekday > 4);
+    return (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
 
-// ============================================================================
-// TEST DATA GENERATOR
-// ============================================================================
-std::vector<TestCase> generateTestData(const BenchmarkConfig& config) {
-    std::vector<TestCase> testCases;
-    testCases.reserve(config.testDataSize + 200);
+constexpr int convertGregorianDateToWeekDate_V4(const struct tm& times) noexcept
+{
+    return weekNumber_V4(times.tm_year + 1900, times.tm_yday + 1);
+}
 
-    std::random_device rd;
-    std::mt19937 gen(42);
-    std::uniform_int_distribution<> year_dist(config.minYear, config.maxYear);
-    std::uniform_int_distribution<> day_dist(1, 365);
+// V5: Per-Year Lookup Table
+// One byte per year holds everything V4 derives from the year alone:
+//   bits 0-2  Jan-1 weekday (1 = Monday ... 7 = Sunday)
+//   bit  3    year is a leap year
+//   bit  4    previous ISO year has 53 weeks
+// The table is built at compile time for [YEAR_TABLE_FIRST, YEAR_TABLE_LAST];
+// years outside that range compute the same byte arithmetically.
+constexpr int YEAR_TABLE_FIRST = 1600;
+constexpr int YEAR_TABLE_LAST = 3199;
 
-    for (size_t i = 0; i < config.testDataSize; ++i) {
-        TestCase tc;
-        int year = year_dist(gen);
-        int dayOfYear = day_dist(gen);
+constexpr uint8_t yearInfoEntry(int y) noexcept
+{
+    const int y_1 = y - 1;
+    const int jan1Weekday = 1 + ((y_1 + (y_1 / 4) - (y_1 / 100) + (y_1 / 400)) % 7);
+    const int isLeap = ((y & 3) == 0) & (((y % 100) != 0) | ((y % 400) == 0));
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 % 100) != 0) | ((y_1 % 400) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    return static_cast<uint8_t>(jan1Weekday | (isLeap << 3) | (prevIs53 << 4));
+}
 
-        int maxDay = (!(year & 3) && ((year % 100) || !(year % 400))) ? 366 : 365;
-        if (dayOfYear > maxDay) {
-            dayOfYear = maxDay;
-        }
+constexpr std::array<uint8_t, YEAR_TABLE_LAST - YEAR_TABLE_FIRST + 1> buildYearInfoTable() noexcept
+{
+    std::array<uint8_t, YEAR_TABLE_LAST - YEAR_TABLE_FIRST + 1> table{};
+    for (int y = YEAR_TABLE_FIRST; y <= YEAR_TABLE_LAST; ++y) {
+        table[y - YEAR_TABLE_FIRST] = yearInfoEntry(y);
+    }
+    return table;
+}
 
-        std::memset(&tc.timeStruct, 0, sizeof(struct tm));
-        tc.timeStruct.tm_year = year - 1900;
-        tc.timeStruct.tm_yday = dayOfYear - 1;
-        tc.year = year;
-        tc.dayOfYear = dayOfYear;
-        tc.description = "Random";
+alignas(64) constexpr auto YEAR_INFO_TABLE = buildYearInfoTable();
 
-        testCases.push_back(tc);
-    }
+constexpr uint8_t yearInfo(int y) noexcept
+{
+    const unsigned index = static_cast<unsigned>(y - YEAR_TABLE_FIRST);
+    return index < YEAR_INFO_TABLE.size() ? YEAR_INFO_TABLE[index] : yearInfoEntry(y);
+}
 
-    if (config.includeEdgeCases) {
-        std::vector<int> centuries = {1800, 1900, 2000, 2100, 2200};
-        for (int cent : centuries) {
-            if (cent >= config.minYear && cent <= config.maxYear) {
-                TestCase tc1;
-                std::memset(&tc1.timeStruct, 0, sizeof(struct tm));
-                tc1.timeStruct.tm_year = cent - 1900;
-                tc1.timeStruct.tm_yday = 0;
-                tc1.year = cent;
-                tc1.dayOfYear = 1;
-                tc1.description = "Century start: " + std::to_string(cent);
-                testCases.push_back(tc1);
-            }
-        }
+constexpr int weekNumber_V5(int y, int dayOfYear) noexcept
+{
+    const unsigned info = yearInfo(y);
+    const unsigned jan1Offset = (info & 7) - 1;                     // 0 = Monday
+    const unsigned t = static_cast<unsigned>(dayOfYear - 1) + jan1Offset;
+    const int weekday = 1 + static_cast<int>(t % 7);
+    const int currYearWeek = static_cast<int>(t / 7) + 1 - (jan1Offset >= 4);
+    const int isPrevYear = currYearWeek == 0;
+    const int prevYearWeek = 52 + static_cast<int>((info >> 4) & 1);
+    const int daysInYear = 365 + static_cast<int>((info >> 3) & 1);
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    return (isPrevYear * prevYearWeek) + isNextYear + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
 
-        for (int year = config.minYear; year <= config.maxYear; year += 4) {
-            if ((!(year & 3) && ((year % 100) || !(year % 400)))) {
-                TestCase tc;
-                std::memset(&tc.timeStruct, 0, sizeof(struct tm));
-                tc.timeStruct.tm_year = year - 1900;
-                tc.timeStruct.tm_yday = 59;
-                tc.year = year;
-                tc.dayOfYear = 60;
-                tc.description = "Leap year Feb 29: " + std::to_string(year);
-                testCases.push_back(tc);
-            }
-        }
-    }
+constexpr int convertGregorianDateToWeekDate_V5(const struct tm& times) noexcept
+{
+    return weekNumber_V5(times.tm_year + 1900, times.tm_yday + 1);
+}
+
+// V6: Multiply-Shift Reciprocals
+// V4 without division instructions: every /7, %7, /100, %100, /400 and %400
+// becomes a 32-bit multiply by a rounded-up reciprocal and a shift (the
+// remainders are x - d * q). Products stay below 2^32, so i586 needs one
+// plain mul each. The constants are exact for
+//   x / 7   = (x * 18725) >> 17    x <= 43692 (largest x: the Jan-1 weekday sum)
+//   x / 100 = (x * 5243) >> 19     x <= 43698
+// and x / 400 = (x / 100) >> 2. That makes V6 valid for years 1-35164; the
+// documented range is 1-MULSHIFT_MAX_YEAR, which --verify-exhaustive covers.
+constexpr int MULSHIFT_MAX_YEAR = 32767;
 
-    return testCases;
+constexpr unsigned div7_MulShift(unsigned x) noexcept { return (x * 18725u) >> 17; }
+constexpr unsigned div100_MulShift(unsigned x) noexcept { return (x * 5243u) >> 19; }
+
+constexpr int weekNumber_V6(int y, int dayOfYear) noexcept
+{
+    const unsigned uy = static_cast<unsigned>(y);
+    const unsigned y_1 = uy - 1;
+    const unsigned q100_1 = div100_MulShift(y_1);
+    const unsigned sum = y_1 + (y_1 >> 2) - q100_1 + (q100_1 >> 2);
+    const int jan1Weekday = 1 + static_cast<int>(sum - 7 * div7_MulShift(sum));
+    const unsigned t = static_cast<unsigned>(dayOfYear + jan1Weekday - 2);
+    const int weekday = 1 + static_cast<int>(t - 7 * div7_MulShift(t));
+    const int isPrevYear = (dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4);
+    // y % 400 == 0 exactly when y % 100 == 0 and (y / 100) % 4 == 0.
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 - 100 * q100_1) != 0) | ((q100_1 & 3) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    const int prevYearWeek = 52 + prevIs53;
+    const unsigned q100 = div100_MulShift(uy);
+    const int isLeap = ((uy & 3) == 0) & (((uy - 100 * q100) != 0) | ((q100 & 3) == 0));
+    const int daysInYear = 365 + isLeap;
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const unsigned j = static_cast<unsigned>(dayOfYear + (7 - weekday) + (jan1Weekday - 1));
+    const int currYearWeek = static_cast<int>(div7_MulShift(j)) - (jan1Weekday > 4);
+    return (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
+
+constexpr int convertGregorianDateToWeekDate_V6(const struct tm& times) noexcept
+{
+    return weekNumber_V6(times.tm_year + 1900, times.tm_yday + 1);
 }
 
 // ============================================================================
-// BENCHMARK RESULT STRUCTURE
+// BATCH CONVERSION (years[] + zero-based ydays[] -> week numbers[])
 // ============================================================================
-template<typename Func>
-struct BenchmarkResult {
-    std::string versionName;
-    double averageTimeNs;
-    double minTimeNs;
-    double maxTimeNs;
-    double medianTimeNs;
-    double percentile95Ns;
-    double percentile99Ns;
-    size_t iterations;
-    bool correctnessCheck;
-    size_t discrepancies;
+// All kernels process min(years.size(), ydays.size(), out.size()) elements.
+// The SIMD kernels evaluate the V4_MathMask formula in 16-bit lanes and
+// replace every division by a multiply-high by a reciprocal constant:
+//   x / 25 = mulhi(x, 20972) >> 3   exact for x < 43690
+//   x / 7  = mulhi(x, 37450) >> 2   exact for x < 43690
+// y / 100 is computed as (y >> 2) / 25 and y / 400 as (y / 100) >> 2, so the
+// largest intermediate (the Jan-1 weekday sum) stays below 41000 for every
+// positive int16 year. Blocks containing a year <= 0 or a yday outside
+// [0, 365] are handed to the scalar kernel, so results always match V4.
 
-    // Memory stats
-    MemoryStats memoryBefore;
-    MemoryStats memoryAfter;
-    size_t functionStackBytes;
-};
+template<typename OutT>
+using BatchFunc = void (*)(std::span<const int16_t>, std::span<const int16_t>, std::span<OutT>) noexcept;
+using BatchWeekFunc = BatchFunc<uint8_t>;
 
-// ============================================================================
-// BENCHMARK FUNCTION
-// ============================================================================
-template<typename Func>
-BenchmarkResult<Func> benchmarkFunction(
-    const std::string& name,
-    Func func,
-    const std::vector<TestCase>& testData,
-    const BenchmarkConfig& config
-) {
-    BenchmarkResult<Func> result;
-    result.versionName = name;
+static inline size_t batchLength(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                                 std::span<uint8_t> out) noexcept
+{
+    return std::min({years.size(), ydays.size(), out.size()});
+}
+
+static inline void weekKernel_Scalar(const int16_t* years, const int16_t* ydays, uint8_t* out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(weekNumber_V4(years[i], ydays[i] + 1));
+    }
+}
+
+void convertWeekDates_Scalar(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                             std::span<uint8_t> out) noexcept
+{
+    weekKernel_Scalar(years.data(), ydays.data(), out.data(), batchLength(years, ydays, out));
+}
+
+#ifdef ISO_WEEK_X86_SIMD
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ISO_WEEK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ISO_WEEK_TARGET(isa)
+#endif
+
+// --- SSE2: 8 lanes --------------------------------------------------------
+static inline __m128i div7_SSE2(__m128i x) noexcept
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16(static_cast<short>(37450))), 2);
+}
+
+static inline __m128i mod7_SSE2(__m128i x) noexcept
+{
+    return _mm_sub_epi16(x, _mm_mullo_epi16(div7_SSE2(x), _mm_set1_epi16(7)));
+}
+
+static inline __m128i div100_SSE2(__m128i y) noexcept
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(_mm_srli_epi16(y, 2), _mm_set1_epi16(20972)), 3);
+}
+
+// All-ones lanes where y is a leap year; q100 must be y / 100.
+static inline __m128i leapMask_SSE2(__m128i y, __m128i q100) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i three = _mm_set1_epi16(3);
+    const __m128i div4 = _mm_cmpeq_epi16(_mm_and_si128(y, three), zero);
+    const __m128i div100 = _mm_cmpeq_epi16(_mm_sub_epi16(y, _mm_mullo_epi16(q100, _mm_set1_epi16(100))), zero);
+    const __m128i div400 = _mm_and_si128(div100, _mm_cmpeq_epi16(_mm_and_si128(q100, three), zero));
+    return _mm_and_si128(div4, _mm_or_si128(_mm_andnot_si128(div100, _mm_set1_epi16(-1)), div400));
+}
+
+static void weekKernel_SSE2(const int16_t* years, const int16_t* ydays, uint8_t* out, size_t n) noexcept
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i four = _mm_set1_epi16(4);
+    const __m128i minusOne = _mm_set1_epi16(-1);
+    const __m128i maxYday = _mm_set1_epi16(366);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(years + i));
+        const __m128i yday = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ydays + i));
+
+        const __m128i valid = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(y, _mm_setzero_si128()),
+                                                          _mm_cmpgt_epi16(yday, minusOne)),
+                                            _mm_cmpgt_epi16(maxYday, yday));
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            weekKernel_Scalar(years + i, ydays + i, out + i, 8);
+            continue;
+        }
+
+        const __m128i dayOfYear = _mm_add_epi16(yday, one);
+        const __m128i y_1 = _mm_sub_epi16(y, one);
+        const __m128i q100_1 = div100_SSE2(y_1);
+        const __m128i sum = _mm_add_epi16(_mm_sub_epi16(_mm_add_epi16(y_1, _mm_srli_epi16(y_1, 2)), q100_1),
+                                          _mm_srli_epi16(q100_1, 2));
+        const __m128i jan1Weekday = _mm_add_epi16(one, mod7_SSE2(sum));
+        const __m128i weekday = _mm_add_epi16(one, mod7_SSE2(_mm_add_epi16(dayOfYear, _mm_sub_epi16(jan1Weekday, _mm_set1_epi16(2)))));
+
+        const __m128i jan1Late = _mm_cmpgt_epi16(jan1Weekday, four);
+        const __m128i isPrevYear = _mm_and_si128(_mm_cmpgt_epi16(_mm_sub_epi16(_mm_set1_epi16(9), jan1Weekday), dayOfYear), jan1Late);
+        const __m128i prevIs53 = _mm_or_si128(_mm_cmpeq_epi16(jan1Weekday, _mm_set1_epi16(5)),
+                                              _mm_and_si128(_mm_cmpeq_epi16(jan1Weekday, _mm_set1_epi16(6)),
+                                                            leapMask_SSE2(y_1, q100_1)));
+        const __m128i prevYearWeek = _mm_sub_epi16(_mm_set1_epi16(52), prevIs53);
+
+        const __m128i daysInYear = _mm_sub_epi16(_mm_set1_epi16(365), leapMask_SSE2(y, div100_SSE2(y)));
+        const __m128i isNextYear = _mm_cmpgt_epi16(_mm_sub_epi16(four, weekday), _mm_sub_epi16(daysInYear, dayOfYear));
+
+        const __m128i j = _mm_sub_epi16(_mm_add_epi16(dayOfYear, _mm_add_epi16(jan1Weekday, _mm_set1_epi16(6))), weekday);
+        const __m128i currYearWeek = _mm_add_epi16(div7_SSE2(j), jan1Late);
+
+        __m128i week = _mm_or_si128(_mm_and_si128(isNextYear, one), _mm_andnot_si128(isNextYear, currYearWeek));
+        week = _mm_or_si128(_mm_and_si128(isPrevYear, prevYearWeek), _mm_andnot_si128(isPrevYear, week));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(week, week));
+    }
+    weekKernel_Scalar(years + i, ydays + i, out + i, n - i);
+}
+
+void convertWeekDates_SSE2(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                           std::span<uint8_t> out) noexcept
+{
+    weekKernel_SSE2(years.data(), ydays.data(), out.data(), batchLength(years, ydays, out));
+}
+
+// --- AVX2: 16 lanes -------------------------------------------------------
+ISO_WEEK_TARGET("avx2") static inline __m256i div7_AVX2(__m256i x) noexcept
+{
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16(static_cast<short>(37450))), 2);
+}
+
+ISO_WEEK_TARGET("avx2") static inline __m256i mod7_AVX2(__m256i x) noexcept
+{
+    return _mm256_sub_epi16(x, _mm256_mullo_epi16(div7_AVX2(x), _mm256_set1_epi16(7)));
+}
+
+ISO_WEEK_TARGET("avx2") static inline __m256i div100_AVX2(__m256i y) noexcept
+{
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_srli_epi16(y, 2), _mm256_set1_epi16(20972)), 3);
+}
+
+ISO_WEEK_TARGET("avx2") static inline __m256i leapMask_AVX2(__m256i y, __m256i q100) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i three = _mm256_set1_epi16(3);
+    const __m256i div4 = _mm256_cmpeq_epi16(_mm256_and_si256(y, three), zero);
+    const __m256i div100 = _mm256_cmpeq_epi16(_mm256_sub_epi16(y, _mm256_mullo_epi16(q100, _mm256_set1_epi16(100))), zero);
+    const __m256i div400 = _mm256_and_si256(div100, _mm256_cmpeq_epi16(_mm256_and_si256(q100, three), zero));
+    return _mm256_and_si256(div4, _mm256_or_si256(_mm256_andnot_si256(div100, _mm256_set1_epi16(-1)), div400));
+}
+
+ISO_WEEK_TARGET("avx2")
+static void weekKernel_AVX2(const int16_t* years, const int16_t* ydays, uint8_t* out, size_t n) noexcept
+{
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i four = _mm256_set1_epi16(4);
+    const __m256i minusOne = _mm256_set1_epi16(-1);
+    const __m256i maxYday = _mm256_set1_epi16(366);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i));
+        const __m256i yday = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ydays + i));
+
+        const __m256i valid = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi16(y, _mm256_setzero_si256()),
+                                                                 _mm256_cmpgt_epi16(yday, minusOne)),
+                                               _mm256_cmpgt_epi16(maxYday, yday));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            weekKernel_Scalar(years + i, ydays + i, out + i, 16);
+            continue;
+        }
+
+        const __m256i dayOfYear = _mm256_add_epi16(yday, one);
+        const __m256i y_1 = _mm256_sub_epi16(y, one);
+        const __m256i q100_1 = div100_AVX2(y_1);
+        const __m256i sum = _mm256_add_epi16(_mm256_sub_epi16(_mm256_add_epi16(y_1, _mm256_srli_epi16(y_1, 2)), q100_1),
+                                             _mm256_srli_epi16(q100_1, 2));
+        const __m256i jan1Weekday = _mm256_add_epi16(one, mod7_AVX2(sum));
+        const __m256i weekday = _mm256_add_epi16(one, mod7_AVX2(_mm256_add_epi16(dayOfYear, _mm256_sub_epi16(jan1Weekday, _mm256_set1_epi16(2)))));
+
+        const __m256i jan1Late = _mm256_cmpgt_epi16(jan1Weekday, four);
+        const __m256i isPrevYear = _mm256_and_si256(_mm256_cmpgt_epi16(_mm256_sub_epi16(_mm256_set1_epi16(9), jan1Weekday), dayOfYear), jan1Late);
+        const __m256i prevIs53 = _mm256_or_si256(_mm256_cmpeq_epi16(jan1Weekday, _mm256_set1_epi16(5)),
+                                                 _mm256_and_si256(_mm256_cmpeq_epi16(jan1Weekday, _mm256_set1_epi16(6)),
+                                                                  leapMask_AVX2(y_1, q100_1)));
+        const __m256i prevYearWeek = _mm256_sub_epi16(_mm256_set1_epi16(52), prevIs53);
+
+        const __m256i daysInYear = _mm256_sub_epi16(_mm256_set1_epi16(365), leapMask_AVX2(y, div100_AVX2(y)));
+        const __m256i isNextYear = _mm256_cmpgt_epi16(_mm256_sub_epi16(four, weekday), _mm256_sub_epi16(daysInYear, dayOfYear));
+
+        const __m256i j = _mm256_sub_epi16(_mm256_add_epi16(dayOfYear, _mm256_add_epi16(jan1Weekday, _mm256_set1_epi16(6))), weekday);
+        const __m256i currYearWeek = _mm256_add_epi16(div7_AVX2(j), jan1Late);
+
+        __m256i week = _mm256_blendv_epi8(currYearWeek, one, isNextYear);
+        week = _mm256_blendv_epi8(week, prevYearWeek, isPrevYear);
+        const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(week), _mm256_extracti128_si256(week, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    weekKernel_Scalar(years + i, ydays + i, out + i, n - i);
+}
+
+void convertWeekDates_AVX2(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                           std::span<uint8_t> out) noexcept
+{
+    weekKernel_AVX2(years.data(), ydays.data(), out.data(), batchLength(years, ydays, out));
+}
+
+// --- AVX-512BW: 32 lanes, comparisons produce k-masks ---------------------
+ISO_WEEK_TARGET("avx512f,avx512bw") static inline __m512i div7_AVX512(__m512i x) noexcept
+{
+    return _mm512_srli_epi16(_mm512_mulhi_epu16(x, _mm512_set1_epi16(static_cast<short>(37450))), 2);
+}
+
+ISO_WEEK_TARGET("avx512f,avx512bw") static inline __m512i mod7_AVX512(__m512i x) noexcept
+{
+    return _mm512_sub_epi16(x, _mm512_mullo_epi16(div7_AVX512(x), _mm512_set1_epi16(7)));
+}
+
+ISO_WEEK_TARGET("avx512f,avx512bw") static inline __m512i div100_AVX512(__m512i y) noexcept
+{
+    return _mm512_srli_epi16(_mm512_mulhi_epu16(_mm512_srli_epi16(y, 2), _mm512_set1_epi16(20972)), 3);
+}
+
+ISO_WEEK_TARGET("avx512f,avx512bw") static inline __mmask32 leapMask_AVX512(__m512i y, __m512i q100) noexcept
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i three = _mm512_set1_epi16(3);
+    const __mmask32 div4 = _mm512_cmpeq_epi16_mask(_mm512_and_si512(y, three), zero);
+    const __mmask32 div100 = _mm512_cmpeq_epi16_mask(_mm512_sub_epi16(y, _mm512_mullo_epi16(q100, _mm512_set1_epi16(100))), zero);
+    const __mmask32 div400 = div100 & _mm512_cmpeq_epi16_mask(_mm512_and_si512(q100, three), zero);
+    return div4 & (~div100 | div400);
+}
+
+ISO_WEEK_TARGET("avx512f,avx512bw")
+static void weekKernel_AVX512(const int16_t* years, const int16_t* ydays, uint8_t* out, size_t n) noexcept
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi16(1);
+    const __m512i four = _mm512_set1_epi16(4);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m512i y = _mm512_loadu_si512(years + i);
+        const __m512i yday = _mm512_loadu_si512(ydays + i);
+
+        const __mmask32 valid = _mm512_cmpgt_epi16_mask(y, zero)
+                              & _mm512_cmpge_epi16_mask(yday, zero)
+                              & _mm512_cmplt_epi16_mask(yday, _mm512_set1_epi16(366));
+        if (valid != 0xFFFFFFFFu) {
+            weekKernel_Scalar(years + i, ydays + i, out + i, 32);
+            continue;
+        }
+
+        const __m512i dayOfYear = _mm512_add_epi16(yday, one);
+        const __m512i y_1 = _mm512_sub_epi16(y, one);
+        const __m512i q100_1 = div100_AVX512(y_1);
+        const __m512i sum = _mm512_add_epi16(_mm512_sub_epi16(_mm512_add_epi16(y_1, _mm512_srli_epi16(y_1, 2)), q100_1),
+                                             _mm512_srli_epi16(q100_1, 2));
+        const __m512i jan1Weekday = _mm512_add_epi16(one, mod7_AVX512(sum));
+        const __m512i weekday = _mm512_add_epi16(one, mod7_AVX512(_mm512_add_epi16(dayOfYear, _mm512_sub_epi16(jan1Weekday, _mm512_set1_epi16(2)))));
+
+        const __mmask32 jan1Late = _mm512_cmpgt_epi16_mask(jan1Weekday, four);
+        const __mmask32 isPrevYear = _mm512_cmple_epi16_mask(dayOfYear, _mm512_sub_epi16(_mm512_set1_epi16(8), jan1Weekday)) & jan1Late;
+        const __mmask32 prevIs53 = _mm512_cmpeq_epi16_mask(jan1Weekday, _mm512_set1_epi16(5))
+                                 | (_mm512_cmpeq_epi16_mask(jan1Weekday, _mm512_set1_epi16(6)) & leapMask_AVX512(y_1, q100_1));
+        const __m512i prevYearWeek = _mm512_mask_add_epi16(_mm512_set1_epi16(52), prevIs53, _mm512_set1_epi16(52), one);
+
+        const __m512i daysInYear = _mm512_mask_add_epi16(_mm512_set1_epi16(365), leapMask_AVX512(y, div100_AVX512(y)),
+                                                         _mm512_set1_epi16(365), one);
+        const __mmask32 isNextYear = _mm512_cmplt_epi16_mask(_mm512_sub_epi16(daysInYear, dayOfYear), _mm512_sub_epi16(four, weekday));
+
+        const __m512i j = _mm512_sub_epi16(_mm512_add_epi16(dayOfYear, _mm512_add_epi16(jan1Weekday, _mm512_set1_epi16(6))), weekday);
+        const __m512i j7 = div7_AVX512(j);
+        const __m512i currYearWeek = _mm512_mask_sub_epi16(j7, jan1Late, j7, one);
+
+        __m512i week = _mm512_mask_blend_epi16(isNextYear, currYearWeek, one);
+        week = _mm512_mask_blend_epi16(isPrevYear, week, prevYearWeek);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_maskz_cvtepi16_epi8(0xFFFFFFFFu, week));
+    }
+    weekKernel_Scalar(years + i, ydays + i, out + i, n - i);
+}
+
+void convertWeekDates_AVX512(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                             std::span<uint8_t> out) noexcept
+{
+    weekKernel_AVX512(years.data(), ydays.data(), out.data(), batchLength(years, ydays, out));
+}
+
+#endif // ISO_WEEK_X86_SIMD
+
+// ============================================================================
+// CPU FEATURE DETECTION / RUNTIME DISPATCH
+// ============================================================================
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+
+    static const CpuFeatures& get() {
+        static const CpuFeatures features = detect();
+        return features;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+#ifdef ISO_WEEK_X86_SIMD
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.avx512f = __builtin_cpu_supports("avx512f");
+        f.avx512bw = f.avx512f && __builtin_cpu_supports("avx512bw");
+#elif defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        const int maxLeaf = regs[0];
+        __cpuid(regs, 1);
+        f.sse2 = (regs[3] >> 26) & 1;
+        const bool osxsave = (regs[2] >> 27) & 1;
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        const bool ymmState = (xcr0 & 0x6) == 0x6;
+        const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+        if (maxLeaf >= 7) {
+            __cpuidex(regs, 7, 0);
+            f.avx2 = ymmState && ((regs[1] >> 5) & 1);
+            f.avx512f = zmmState && ((regs[1] >> 16) & 1);
+            f.avx512bw = f.avx512f && ((regs[1] >> 30) & 1);
+        }
+#endif
+#endif
+        return f;
+    }
+};
+
+// Best kernel for the running CPU, resolved once.
+inline BatchWeekFunc selectBatchKernel(const char** kernelName = nullptr) {
+    const CpuFeatures& cpu = CpuFeatures::get();
+    BatchWeekFunc func = convertWeekDates_Scalar;
+    const char* name = "Scalar";
+#ifdef ISO_WEEK_X86_SIMD
+    if (cpu.avx512bw) {
+        func = convertWeekDates_AVX512;
+        name = "AVX512";
+    } else if (cpu.avx2) {
+        func = convertWeekDates_AVX2;
+        name = "AVX2";
+    } else if (cpu.sse2) {
+        func = convertWeekDates_SSE2;
+        name = "SSE2";
+    }
+#else
+    (void)cpu;
+#endif
+    if (kernelName) {
+        *kernelName = name;
+    }
+    return func;
+}
+
+void convertWeekDates(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                      std::span<uint8_t> out) noexcept
+{
+    static const BatchWeekFunc kernel = selectBatchKernel();
+    kernel(years, ydays, out);
+}
+
+// ============================================================================
+// FULL ISO WEEK DATE RESULT (ISO year, week, weekday)
+// ============================================================================
+struct IsoWeekDate {
+    int16_t isoYear;
+    uint8_t week;       // 1..53
+    uint8_t weekday;    // 1 = Monday ... 7 = Sunday
+
+    bool operator==(const IsoWeekDate&) const = default;
+};
+
+// Packed form: bits 16-31 ISO year, bits 8-15 week, bits 0-7 weekday.
+// For non-negative years packed values sort in calendar order.
+constexpr uint32_t packIsoWeekDate(IsoWeekDate d) noexcept
+{
+    return (static_cast<uint32_t>(static_cast<uint16_t>(d.isoYear)) << 16)
+         | (static_cast<uint32_t>(d.week) << 8)
+         | d.weekday;
+}
+
+constexpr IsoWeekDate unpackIsoWeekDate(uint32_t packed) noexcept
+{
+    return {static_cast<int16_t>(packed >> 16), static_cast<uint8_t>(packed >> 8), static_cast<uint8_t>(packed)};
+}
+
+constexpr IsoWeekDate makeIsoWeekDate(int isoYear, int week, int weekday) noexcept
+{
+    return {static_cast<int16_t>(isoYear), static_cast<uint8_t>(week), static_cast<uint8_t>(weekday)};
+}
+
+// The fields the conversions read; everything else zero.
+constexpr struct tm timeStructFor(int year, int yday) noexcept
+{
+    struct tm times{};
+    times.tm_year = year - 1900;
+    times.tm_yday = yday;
+    return times;
+}
+
+// Original version (full result)
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_Original(const struct tm& times) noexcept
+{
+    const int y = times.tm_year + 1900;
+    const int dayOfYearNumber = times.tm_yday + 1;
+
+    const int yy = (y - 1) % 100;
+    const int c = (y - 1) - yy;
+    const int g = yy + yy / 4;
+    const int jan1Weekday = 1 + (((((c / 100) % 4) * 5) + g) % 7);
+
+    const int h = dayOfYearNumber + (jan1Weekday - 1);
+    const int weekday = 1 + ((h - 1) % 7);
+
+    int yearNumber = 0, weekNumber = 0;
+
+    if ((dayOfYearNumber <= (8 - jan1Weekday)) && (jan1Weekday > 4))
+    {
+        yearNumber = y - 1;
+        weekNumber = ((jan1Weekday == 5) || ((jan1Weekday == 6) &&
+            (!(yearNumber & 3) && ((yearNumber % 100) || !(yearNumber % 400))))) ? 53 : 52;
+    }
+    else
+    {
+        yearNumber = y;
+        const int daysInYear = (!(y & 3) && ((y % 100) || !(y % 400))) ? 366 : 365;
+
+        if ((daysInYear - dayOfYearNumber) < (4 - weekday))
+        {
+            yearNumber = y + 1;
+            weekNumber = 1;
+        }
+    }
+
+    if (yearNumber == y)
+    {
+        const int j = dayOfYearNumber + (7 - weekday) + (jan1Weekday - 1);
+        weekNumber = j / 7;
+        if (jan1Weekday > 4)
+            weekNumber--;
+    }
+
+    return makeIsoWeekDate(yearNumber, weekNumber, weekday);
+}
+
+// V1: Early Return (full result)
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_V1(const struct tm& times) noexcept
+{
+    const int y = times.tm_year + 1900;
+    const int dayOfYear = times.tm_yday + 1;
+
+    const int yy = (y - 1) % 100;
+    const int c = (y - 1) - yy;
+    const int g = yy + yy / 4;
+    const int jan1Weekday = 1 + (((((c / 100) % 4) * 5) + g) % 7);
+
+    const int h = dayOfYear + (jan1Weekday - 1);
+    const int weekday = 1 + ((h - 1) % 7);
+
+    if ((dayOfYear <= (8 - jan1Weekday)) && (jan1Weekday > 4))
+    {
+        const int y_1 = y - 1;
+        const int week = ((jan1Weekday == 5) || ((jan1Weekday == 6) && (!(y_1 & 3) && ((y_1 % 100) || !(y_1 % 400))))) ? 53 : 52;
+        return makeIsoWeekDate(y_1, week, weekday);
+    }
+
+    const int daysInYear = (!(y & 3) && ((y % 100) || !(y % 400))) ? 366 : 365;
+    if ((daysInYear - dayOfYear) < (4 - weekday))
+    {
+        return makeIsoWeekDate(y + 1, 1, weekday);
+    }
+
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    int weekNumber = j / 7;
+    if (jan1Weekday > 4)
+        weekNumber--;
+
+    return makeIsoWeekDate(y, weekNumber, weekday);
+}
+
+// V2: Bitwise Operations (full result)
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_V2(const struct tm& times) noexcept
+{
+    const int y = times.tm_year + 1900;
+    const int dayOfYear = times.tm_yday + 1;
+
+    const int y_1 = y - 1;
+    const int yy = y_1 % 100;
+    const int c = y_1 - yy;
+    const int g = yy + (yy >> 2);
+    const int jan1Weekday = 1 + (((((c / 100) & 3) * 5) + g) % 7);
+
+    const int weekday = 1 + ((dayOfYear + jan1Weekday - 2) % 7);
+
+    if ((dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4))
+    {
+        const int prevYearLeap = (!(y_1 & 3) && ((y_1 % 100) || !(y_1 % 400)));
+        const int is53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+        return makeIsoWeekDate(y_1, 52 + is53, weekday);
+    }
+
+    const int daysInYear = 365 + (!(y & 3) && ((y % 100) || !(y % 400)));
+    if ((daysInYear - dayOfYear) < (4 - weekday))
+    {
+        return makeIsoWeekDate(y + 1, 1, weekday);
+    }
+
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    const int weekNumber = (j / 7) - (jan1Weekday > 4);
+
+    return makeIsoWeekDate(y, weekNumber, weekday);
+}
+
+// V3: Calculation Splitting (full result)
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_V3(const struct tm& times) noexcept
+{
+    const int y = times.tm_year + 1900;
+    const int dayOfYear = times.tm_yday + 1;
+    const int y_1 = y - 1;
+
+    const int prevYearLeap = (!(y_1 & 3) && ((y_1 % 100) || !(y_1 % 400)));
+    const int yy = y_1 % 100;
+    const int g = yy + (yy >> 2);
+    const int c_div_100 = y_1 / 100;
+    const int jan1Weekday = 1 + ((((c_div_100 & 3) * 5) + g) % 7);
+
+    const int currYearLeap = (!(y & 3) && ((y % 100) || !(y % 400)));
+    const int daysInYear = 365 + currYearLeap;
+
+    const int weekday = 1 + ((dayOfYear + jan1Weekday - 2) % 7);
+
+    if ((dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4))
+    {
+        const int is53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+        return makeIsoWeekDate(y_1, 52 + is53, weekday);
+    }
+
+    if ((daysInYear - dayOfYear) < (4 - weekday))
+    {
+        return makeIsoWeekDate(y + 1, 1, weekday);
+    }
+
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    const int weekNumber = (j / 7) - (jan1Weekday > 4);
+
+    return makeIsoWeekDate(y, weekNumber, weekday);
+}
+
+// V4: Mathematical Masks (full result)
+constexpr IsoWeekDate isoWeekDate_V4(int y, int dayOfYear) noexcept
+{
+    const int y_1 = y - 1;
+    const int jan1Weekday = 1 + ((y_1 + (y_1 / 4) - (y_1 / 100) + (y_1 / 400)) % 7);
+    const int weekday = 1 + ((dayOfYear + jan1Weekday - 2) % 7);
+    const int isPrevYear = (dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4);
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 % 100) != 0) | ((y_1 % 400) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    const int prevYearWeek = 52 + prevIs53;
+    const int isLeap = ((y & 3) == 0) & (((y % 100) != 0) | ((y % 400) == 0));
+    const int daysInYear = 365 + isLeap;
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    const int currYearWeek = (j / 7) - (jan1Weekday > 4);
+    const int week = (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+    return makeIsoWeekDate(y - isPrevYear + isNextYear, week, weekday);
+}
+
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_V4(const struct tm& times) noexcept
+{
+    return isoWeekDate_V4(times.tm_year + 1900, times.tm_yday + 1);
+}
+
+// V5: Per-Year Lookup Table (full result)
+constexpr IsoWeekDate isoWeekDate_V5(int y, int dayOfYear) noexcept
+{
+    const unsigned info = yearInfo(y);
+    const unsigned jan1Offset = (info & 7) - 1;
+    const unsigned t = static_cast<unsigned>(dayOfYear - 1) + jan1Offset;
+    const int weekday = 1 + static_cast<int>(t % 7);
+    const int currYearWeek = static_cast<int>(t / 7) + 1 - (jan1Offset >= 4);
+    const int isPrevYear = currYearWeek == 0;
+    const int prevYearWeek = 52 + static_cast<int>((info >> 4) & 1);
+    const int daysInYear = 365 + static_cast<int>((info >> 3) & 1);
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const int week = (isPrevYear * prevYearWeek) + isNextYear + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+    return makeIsoWeekDate(y - isPrevYear + isNextYear, week, weekday);
+}
+
+constexpr IsoWeekDate convertGregorianDateToIsoWeekDate_V5(const struct tm& times) noexcept
+{
+    return isoWeekDate_V5(times.tm_year + 1900, times.tm_yday + 1);
+}
+
+// Batch variants, built on V5; same span conventions as convertWeekDates().
+void convertIsoWeekDates(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                         std::span<IsoWeekDate> out) noexcept
+{
+    const size_t n = std::min({years.size(), ydays.size(), out.size()});
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = isoWeekDate_V5(years[i], ydays[i] + 1);
+    }
+}
+
+void convertIsoWeekDatesPacked(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                               std::span<uint32_t> out) noexcept
+{
+    const size_t n = std::min({years.size(), ydays.size(), out.size()});
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = packIsoWeekDate(isoWeekDate_V5(years[i], ydays[i] + 1));
+    }
+}
+
+// Week-only counterpart of the above, for measuring the cost of the full result.
+void convertWeekDates_Table(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                            std::span<uint8_t> out) noexcept
+{
+    const size_t n = std::min({years.size(), ydays.size(), out.size()});
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(weekNumber_V5(years[i], ydays[i] + 1));
+    }
+}
+
+// ============================================================================
+// SORTED STREAMS (IsoWeekCursor)
+// ============================================================================
+// For (nearly) monotonic input. The cursor caches the current calendar year
+// (length, yday of the Monday of ISO week 1 of this year and of the next one,
+// week count of the previous ISO year) and the ISO week it last returned.
+// A date in that week is a subtract-and-compare; stepping into the following
+// week is an add; only a change of year goes back to the V5 year byte.
+// advance() moves by a day delta from the last date instead: short moves step
+// the cached week, and a year end rebases it onto the new Jan 1.
+// Any order gives correct results, unsorted input just takes the slow paths.
+constexpr int daysInYear(int y) noexcept
+{
+    return (!(y & 3) && ((y % 100) || !(y % 400))) ? 366 : 365;
+}
+
+class IsoWeekCursor {
+public:
+    // yday is zero-based, like tm_yday.
+    IsoWeekDate at(int year, int yday) noexcept
+    {
+        if (year == cachedYear && static_cast<unsigned>(yday - weekBegin) < 7u) {
+            return current(yday);
+        }
+        if (year != cachedYear) {
+            loadYear(year);
+        }
+        return seek(yday);
+    }
+
+    // Moves the last position by deltaDays (either sign) across year ends.
+    // A cursor that has no position yet (no at() call) returns week 0.
+    IsoWeekDate advance(int deltaDays) noexcept
+    {
+        if (cachedYear == NO_YEAR) [[unlikely]] {
+            return {};
+        }
+        const int yday = lastYday + deltaDays;
+        if (static_cast<unsigned>(yday) >= static_cast<unsigned>(yearLength)) [[unlikely]] {
+            return crossYears(yday);
+        }
+        if (isoYear == cachedYear && deltaDays > -CURSOR_STEP_DAYS && deltaDays < CURSOR_STEP_DAYS) {
+            // Whole weeks within the ISO year: add and compare, no division.
+            while (yday - weekBegin >= 7 && weekBegin + 7 < nextWeek1Begin) {
+                weekBegin += 7;
+                ++week;
+            }
+            while (yday < weekBegin && weekBegin > week1Begin) {
+                weekBegin -= 7;
+                --week;
+            }
+        }
+        if (static_cast<unsigned>(yday - weekBegin) < 7u) {
+            return current(yday);
+        }
+        return seek(yday);
+    }
+
+private:
+    static constexpr int NO_YEAR = std::numeric_limits<int>::min();
+    static constexpr int CURSOR_STEP_DAYS = 28;         // Longer moves recompute the week
+
+    int cachedYear = NO_YEAR;
+    int yearLength = 0;
+    int week1Begin = 0;             // yday of Monday of ISO week 1 (-3..3)
+    int nextWeek1Begin = 0;         // Same for the next year, counted from this year's Jan 1
+    int prevYearWeeks = 0;          // 52 or 53
+    int weekBegin = 0;              // yday of the Monday of the cached week
+    int isoYear = 0;
+    int week = 0;
+    int lastYday = 0;
+
+    IsoWeekDate current(int yday) noexcept
+    {
+        lastYday = yday;
+        return makeIsoWeekDate(isoYear, week, yday - weekBegin + 1);
+    }
+
+    void loadYear(int year) noexcept
+    {
+        const unsigned info = yearInfo(year);
+        const int jan1 = static_cast<int>(info & 7);                // 1 = Monday
+        yearLength = 365 + static_cast<int>((info >> 3) & 1);
+        week1Begin = jan1 <= 4 ? 1 - jan1 : 8 - jan1;
+        const int nextJan1 = (jan1 - 1 + yearLength) % 7 + 1;
+        nextWeek1Begin = yearLength + (nextJan1 <= 4 ? 1 - nextJan1 : 8 - nextJan1);
+        prevYearWeeks = 52 + static_cast<int>((info >> 4) & 1);
+        cachedYear = year;
+        weekBegin = std::numeric_limits<int>::min() / 2;           // No cached week in the new year
+    }
+
+    // Loads the year(s) yday (counted from the cached Jan 1) falls in. The
+    // cached week is rebased onto the new Jan 1, since a week that spans
+    // the year end stays valid on both sides.
+    IsoWeekDate crossYears(int yday) noexcept
+    {
+        int year = cachedYear;
+        int begin = weekBegin;
+        while (yday >= yearLength) {
+            yday -= yearLength;
+            begin -= yearLength;
+            loadYear(++year);
+        }
+        while (yday < 0) {
+            loadYear(--year);
+            yday += yearLength;
+            begin += yearLength;
+        }
+        weekBegin = begin;
+        if (static_cast<unsigned>(yday - weekBegin) < 7u) {
+            return current(yday);
+        }
+        return seek(yday);
+    }
+
+    IsoWeekDate seek(int yday) noexcept
+    {
+        if (isoYear == cachedYear && static_cast<unsigned>(yday - weekBegin - 7) < 7u
+            && weekBegin + 7 < nextWeek1Begin) {
+            weekBegin += 7;                                         // Next week of the same ISO year
+            ++week;
+        } else if (yday < week1Begin) {
+            weekBegin = week1Begin - 7;
+            isoYear = cachedYear - 1;
+            week = prevYearWeeks;
+        } else if (yday >= nextWeek1Begin) {
+            weekBegin = nextWeek1Begin;
+            isoYear = cachedYear + 1;
+            week = 1;
+        } else {
+            week = (yday - week1Begin) / 7 + 1;
+            weekBegin = week1Begin + (week - 1) * 7;
+            isoYear = cachedYear;
+        }
+        return current(yday);
+    }
+};
+
+// Batch entry points over a cursor; same span conventions as convertWeekDates().
+void convertSorted(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                   std::span<IsoWeekDate> out) noexcept
+{
+    const size_t n = std::min({years.size(), ydays.size(), out.size()});
+    IsoWeekCursor cursor;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = cursor.at(years[i], ydays[i]);
+    }
+}
+
+void convertSortedWeeks(std::span<const int16_t> years, std::span<const int16_t> ydays,
+                        std::span<uint8_t> out) noexcept
+{
+    const size_t n = std::min({years.size(), ydays.size(), out.size()});
+    IsoWeekCursor cursor;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = cursor.at(years[i], ydays[i]).week;
+    }
+}
+
+// ============================================================================
+// TEXT DATES (YYYY-MM-DD)
+// ============================================================================
+// One record per line; the first 10 characters of a line are the date and
+// anything after them (",...", "T12:00:00Z", "\r") is ignored. Dates are
+// parsed into a fixed block of year/yday columns on the stack, with month and
+// day turned into yday by table, and each block goes through the dispatched
+// convertWeekDates() kernel, so nothing is allocated per record or per call.
+// Lines that are not a valid date of years 0001-9999 get week 0.
+constexpr size_t ISO_DATE_TEXT_CHARS = 10;
+constexpr size_t ISO_DATE_LINE_BYTES = ISO_DATE_TEXT_CHARS + 1;     // Fixed-width line with '\n'
+constexpr size_t TEXT_BLOCK = 512;
+
+constexpr int16_t DAYS_BEFORE_MONTH[2][14] = {
+    {0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366},
+};
+
+// Zero-based day of the year, or -1 when the date does not exist.
+constexpr int ydayFromDate(int year, int month, int day) noexcept
+{
+    if (year < 1 || month < 1 || month > 12 || day < 1) {
+        return -1;
+    }
+    const int leap = static_cast<int>((yearInfo(year) >> 3) & 1);
+    const int first = DAYS_BEFORE_MONTH[leap][month];
+    return day <= DAYS_BEFORE_MONTH[leap][month + 1] - first ? first + day - 1 : -1;
+}
+
+inline int parseIsoDate_Scalar(const char* p, int& year) noexcept
+{
+    unsigned digits[ISO_DATE_TEXT_CHARS];
+    bool ok = p[4] == '-' && p[7] == '-';
+    for (size_t i = 0; i < ISO_DATE_TEXT_CHARS; ++i) {
+        digits[i] = static_cast<unsigned>(static_cast<unsigned char>(p[i])) - '0';
+        ok &= i == 4 || i == 7 || digits[i] <= 9;
+    }
+    if (!ok) {
+        return -1;
+    }
+    year = static_cast<int>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+    return ydayFromDate(year, static_cast<int>(digits[5] * 10 + digits[6]), static_cast<int>(digits[8] * 10 + digits[9]));
+}
+
+#ifdef ISO_WEEK_X86_SIMD
+// One 16-byte load per date (p must have 16 readable bytes): digits and the
+// two dashes are checked with one compare each, and the fields are combined by
+// a single multiply-add against the place values.
+inline int parseIsoDate_SSE2(const char* p, int& year) noexcept
+{
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i digits = _mm_sub_epi8(raw, _mm_set1_epi8('0'));
+    const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const __m128i isDash = _mm_cmpeq_epi8(raw, _mm_set1_epi8('-'));
+    const int shape = (_mm_movemask_epi8(isDigit) & 0x36F) | (_mm_movemask_epi8(isDash) & 0x090);
+    if (shape != 0x3FF) {
+        return -1;
+    }
+    // Y Y Y Y - M M - | D D  ->  (Y*1000 + Y*100) (Y*10 + Y) (M*10) (M) | (D*10 + D)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(digits, zero), _mm_setr_epi16(1000, 100, 10, 1, 0, 10, 1, 0));
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(digits, zero), _mm_setr_epi16(10, 1, 0, 0, 0, 0, 0, 0));
+    const __m128i fields = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    year = _mm_cvtsi128_si32(fields);
+    return ydayFromDate(year, _mm_cvtsi128_si32(_mm_shuffle_epi32(fields, 2)), _mm_cvtsi128_si32(hi));
+}
+#endif
+
+struct TextDateStats {
+    size_t records = 0;                 // Lines converted (== weeks written)
+    size_t invalid = 0;                 // Of those, lines that were not a date (week 0)
+    size_t consumed = 0;                // Bytes of text used; the rest is a partial line or did not fit
+};
+
+// Parses the line at p (p < end) into year and yday, with yday -1 when it is
+// not a date. Returns the start of the next line, or nullptr for a final line
+// without '\n' unless endOfInput is set.
+template<bool Simd>
+inline const char* parseIsoDateLine(const char* p, const char* end, bool endOfInput, int& year, int& yday) noexcept
+{
+    const char* lineEnd = p + ISO_DATE_TEXT_CHARS;
+    if (lineEnd >= end || *lineEnd != '\n') {
+        lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            if (!endOfInput) {
+                return nullptr;
+            }
+            lineEnd = end;
+        }
+    }
+    year = 0;
+    yday = -1;
+    if (static_cast<size_t>(lineEnd - p) >= ISO_DATE_TEXT_CHARS) {
+#ifdef ISO_WEEK_X86_SIMD
+        if constexpr (Simd) {
+            yday = end - p >= 16 ? parseIsoDate_SSE2(p, year) : parseIsoDate_Scalar(p, year);
+        } else
+#endif
+        {
+            yday = parseIsoDate_Scalar(p, year);
+        }
+    }
+    return lineEnd + (lineEnd < end);
+}
+
+// Converts complete lines of text into weeks, stopping when weeks is full. A
+// final line without '\n' is only taken when endOfInput is set, so a stream
+// can be fed buffer by buffer, carrying text.substr(consumed) over.
+template<bool Simd>
+TextDateStats convertIsoDateTextImpl(std::string_view text, std::span<uint8_t> weeks, bool endOfInput) noexcept
+{
+    int16_t years[TEXT_BLOCK];
+    int16_t ydays[TEXT_BLOCK];
+    uint16_t invalid[TEXT_BLOCK];
+    TextDateStats stats;
+    const char* p = text.data();
+    const char* const end = p + text.size();
+
+    while (stats.records < weeks.size() && p < end) {
+        const size_t want = std::min(TEXT_BLOCK, weeks.size() - stats.records);
+        size_t count = 0;
+        size_t invalidCount = 0;
+        for (; count < want && p < end; ++count) {
+            int year;
+            int yday;
+            const char* next = parseIsoDateLine<Simd>(p, end, endOfInput, year, yday);
+            if (!next) {
+                break;
+            }
+            if (yday < 0) {
+                invalid[invalidCount++] = static_cast<uint16_t>(count);
+                year = 2000;
+                yday = 0;
+            }
+            years[count] = static_cast<int16_t>(year);
+            ydays[count] = static_cast<int16_t>(yday);
+            p = next;
+        }
+        if (count == 0) {
+            break;
+        }
+        const std::span<uint8_t> out = weeks.subspan(stats.records, count);
+        if constexpr (Simd) {
+            convertWeekDates(std::span<const int16_t>(years, count), std::span<const int16_t>(ydays, count), out);
+        } else {
+            convertWeekDates_Scalar(std::span<const int16_t>(years, count), std::span<const int16_t>(ydays, count), out);
+        }
+        for (size_t k = 0; k < invalidCount; ++k) {
+            out[invalid[k]] = 0;
+        }
+        stats.records += count;
+        stats.invalid += invalidCount;
+        stats.consumed = static_cast<size_t>(p - text.data());
+    }
+    return stats;
+}
+
+// SSE2 parser and the dispatched batch kernel.
+TextDateStats convertIsoDateText(std::string_view text, std::span<uint8_t> weeks, bool endOfInput = true) noexcept
+{
+    return convertIsoDateTextImpl<true>(text, weeks, endOfInput);
+}
+
+// Scalar parser and convertWeekDates_Scalar().
+TextDateStats convertIsoDateText_Scalar(std::string_view text, std::span<uint8_t> weeks, bool endOfInput = true) noexcept
+{
+    return convertIsoDateTextImpl<false>(text, weeks, endOfInput);
+}
+
+#ifndef _WIN32
+// Baseline: strptime() per line, then Original on the struct tm.
+TextDateStats convertIsoDateText_strptime(std::string_view text, std::span<uint8_t> weeks, bool endOfInput = true) noexcept
+{
+    TextDateStats stats;
+    char line[ISO_DATE_TEXT_CHARS + 1];
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    while (stats.records < weeks.size() && p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            if (!endOfInput) {
+                break;
+            }
+            lineEnd = end;
+        }
+        const size_t length = std::min(ISO_DATE_TEXT_CHARS, static_cast<size_t>(lineEnd - p));
+        std::memcpy(line, p, length);
+        line[length] = '\0';
+        struct tm times;
+        std::memset(&times, 0, sizeof(times));
+        const char* parsed = strptime(line, "%Y-%m-%d", &times);
+        if (parsed && *parsed == '\0' && length == ISO_DATE_TEXT_CHARS) {
+            weeks[stats.records] = static_cast<uint8_t>(convertGregorianDateToWeekDate_Original(times));
+        } else {
+            weeks[stats.records] = 0;
+            ++stats.invalid;
+        }
+        ++stats.records;
+        p = lineEnd + (lineEnd < end);
+        stats.consumed = static_cast<size_t>(p - text.data());
+    }
+    return stats;
+}
+#endif
+
+// Writes "YYYY-MM-DD\n" for a zero-based yday; the fixed-width form the
+// benchmark and verifier feed to the text variants.
+inline void formatIsoDateLine(int year, int yday, char* out) noexcept
+{
+    const int leap = static_cast<int>((yearInfo(year) >> 3) & 1);
+    int month = 1;
+    while (yday >= DAYS_BEFORE_MONTH[leap][month + 1]) {
+        ++month;
+    }
+    const int day = yday - DAYS_BEFORE_MONTH[leap][month] + 1;
+    const char text[] = {
+        static_cast<char>('0' + year / 1000 % 10), static_cast<char>('0' + year / 100 % 10),
+        static_cast<char>('0' + year / 10 % 10), static_cast<char>('0' + year % 10), '-',
+        static_cast<char>('0' + month / 10), static_cast<char>('0' + month % 10), '-',
+        static_cast<char>('0' + day / 10), static_cast<char>('0' + day % 10), '\n',
+    };
+    std::memcpy(out, text, sizeof(text));
+}
+
+// ============================================================================
+// EPOCH-BASED CONVERSION (days since 1970-01-01 / Unix seconds, no struct tm)
+// ============================================================================
+// The ISO year and week of a date are the calendar year of the Thursday of its
+// week and that Thursday's yday / 7 + 1. So one civil-from-days step on the
+// Thursday (Howard Hinnant's era/year-of-era algorithm, written without
+// branches) replaces gmtime_r() plus the year-based formula.
+
+struct YearDay {
+    int64_t year;
+    int yday;       // zero-based, like tm_yday
+};
+
+constexpr YearDay civilYearDayFromDays(int64_t days) noexcept
+{
+    const int64_t z = days + 719468;                              // days since 0000-03-01
+    const int64_t era = (z - (z < 0) * 146096) / 146097;          // floor division
+    const int64_t doe = z - era * 146097;                         // [0, 146096]
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const int64_t doyMar = doe - (365 * yoe + yoe / 4 - yoe / 100);             // March-based, [0, 365]
+    const int64_t isJanFeb = doyMar >= 306;
+    const int64_t isLeap = ((yoe & 3) == 0) & (((yoe % 100) != 0) | (yoe == 0));
+    return {era * 400 + yoe + isJanFeb, static_cast<int>(doyMar - 306 + (1 - isJanFeb) * (365 + isLeap))};
+}
+
+// Inverse of civilYearDayFromDays() for Jan-based (year, yday).
+constexpr int64_t daysFromYearDay(int64_t year, int yday) noexcept
+{
+    const int64_t y = year - 1;                                   // Jan 1 belongs to the previous March-year
+    const int64_t era = (y - (y < 0) * 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + 306;
+    return era * 146097 + doe - 719468 + yday;
+}
+
+// Floor division without the seconds - 86399 step, which overflows at INT64_MIN.
+constexpr int64_t floorDaysFromSeconds(int64_t seconds) noexcept
+{
+    return seconds / 86400 - (seconds % 86400 < 0);
+}
+
+// Epoch input taken from outside the process (service requests, column
+// files) must lie in the four-digit ISO 8601 years, 0001-01-01 through
+// 9999-12-31. Every ISO year of that range fits the packed form.
+constexpr int64_t EPOCH_INPUT_MIN_DAYS = daysFromYearDay(1, 0);
+constexpr int64_t EPOCH_INPUT_MAX_DAYS = daysFromYearDay(10000, 0) - 1;
+constexpr int64_t EPOCH_INPUT_MIN_SECONDS = EPOCH_INPUT_MIN_DAYS * 86400;
+constexpr int64_t EPOCH_INPUT_MAX_SECONDS = EPOCH_INPUT_MAX_DAYS * 86400 + 86399;
+
+constexpr bool epochDaysInRange(int64_t days) noexcept
+{
+    return (days >= EPOCH_INPUT_MIN_DAYS) & (days <= EPOCH_INPUT_MAX_DAYS);
+}
+
+constexpr bool epochSecondsInRange(int64_t seconds) noexcept
+{
+    return (seconds >= EPOCH_INPUT_MIN_SECONDS) & (seconds <= EPOCH_INPUT_MAX_SECONDS);
+}
+
+constexpr IsoWeekDate convertEpochDaysToIsoWeekDate(int64_t days) noexcept
+{
+    const int64_t r = (days + 3) % 7;                             // 1970-01-01 was a Thursday
+    const int64_t weekdayIndex = r + 7 * (r < 0);                 // 0 = Monday
+    const YearDay thursday = civilYearDayFromDays(days - weekdayIndex + 3);
+    return makeIsoWeekDate(static_cast<int>(thursday.year), thursday.yday / 7 + 1, static_cast<int>(weekdayIndex) + 1);
+}
+
+constexpr int convertEpochDaysToWeek(int64_t days) noexcept
+{
+    const int64_t r = (days + 3) % 7;
+    const int64_t weekdayIndex = r + 7 * (r < 0);
+    return civilYearDayFromDays(days - weekdayIndex + 3).yday / 7 + 1;
+}
+
+constexpr int convertEpochSecondsToWeek(int64_t seconds) noexcept
+{
+    return convertEpochDaysToWeek(floorDaysFromSeconds(seconds));
+}
+
+constexpr IsoWeekDate convertEpochSecondsToIsoWeekDate(int64_t seconds) noexcept
+{
+    return convertEpochDaysToIsoWeekDate(floorDaysFromSeconds(seconds));
+}
+
+template<typename InT>
+using EpochBatchFunc = void (*)(std::span<const InT>, std::span<uint8_t>) noexcept;
+
+static inline void epochDaysKernel_Scalar(const int32_t* days, uint8_t* out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(convertEpochDaysToWeek(days[i]));
+    }
+}
+
+void convertEpochDaysToWeeks_Scalar(std::span<const int32_t> days, std::span<uint8_t> out) noexcept
+{
+    epochDaysKernel_Scalar(days.data(), out.data(), std::min(days.size(), out.size()));
+}
+
+#ifdef ISO_WEEK_X86_SIMD
+
+// 32-bit lanes. Every division uses an unsigned multiply-high (x * M) >> (32 + s)
+// that is exact over the operand range noted, so lanes must satisfy
+// z = days + 719468 in [3, 2^31 - 8); other lanes go to the scalar kernel.
+//   (z + 2) / 7       M = 2454267027, s = 2
+//   zth / 146097      M = 963315389,  s = 15
+//   doe / 1460        M = 2941759,    s = 0   (doe < 146097)
+//   doe / 36524       M = 235187,     s = 1
+//   doe / 146096      M = 235187,     s = 3
+//   n / 365           M = 11767034,   s = 0   (n < 146097)
+//   yoe / 100         M = 42949673,   s = 0   (yoe < 400)
+//   yday / 7          M = 613566757,  s = 0   (yday < 400)
+constexpr int32_t EPOCH_SIMD_MIN_DAYS = 3 - 719468;
+constexpr int32_t EPOCH_SIMD_MAX_DAYS = 2147483647 - 8 - 719468;
+
+ISO_WEEK_TARGET("avx2") static inline __m256i mulhi_epu32_AVX2(__m256i x, uint32_t m) noexcept
+{
+    const __m256i mv = _mm256_set1_epi32(static_cast<int>(m));
+    const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, mv), 32);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), mv);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+ISO_WEEK_TARGET("avx2")
+static void epochDaysKernel_AVX2(const int32_t* days, uint8_t* out, size_t n) noexcept
+{
+    const __m256i seven = _mm256_set1_epi32(7);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(days + i));
+        const __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(d, _mm256_set1_epi32(EPOCH_SIMD_MIN_DAYS - 1)),
+                                               _mm256_cmpgt_epi32(_mm256_set1_epi32(EPOCH_SIMD_MAX_DAYS), d));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            epochDaysKernel_Scalar(days + i, out + i, 8);
+            continue;
+        }
+
+        const __m256i z = _mm256_add_epi32(d, _mm256_set1_epi32(719468));
+        const __m256i z2 = _mm256_add_epi32(z, _mm256_set1_epi32(2));
+        const __m256i weekdayIndex = _mm256_sub_epi32(z2, _mm256_mullo_epi32(_mm256_srli_epi32(mulhi_epu32_AVX2(z2, 2454267027u), 2), seven));
+        const __m256i zth = _mm256_add_epi32(_mm256_sub_epi32(z, weekdayIndex), _mm256_set1_epi32(3));
+
+        const __m256i era = _mm256_srli_epi32(mulhi_epu32_AVX2(zth, 963315389u), 15);
+        const __m256i doe = _mm256_sub_epi32(zth, _mm256_mullo_epi32(era, _mm256_set1_epi32(146097)));
+        const __m256i q36524 = mulhi_epu32_AVX2(doe, 235187u);
+        const __m256i yoeNum = _mm256_sub_epi32(_mm256_add_epi32(_mm256_sub_epi32(doe, mulhi_epu32_AVX2(doe, 2941759u)),
+                                                                 _mm256_srli_epi32(q36524, 1)),
+                                                _mm256_srli_epi32(q36524, 3));
+        const __m256i yoe = mulhi_epu32_AVX2(yoeNum, 11767034u);
+        const __m256i q100 = mulhi_epu32_AVX2(yoe, 42949673u);
+        const __m256i doyMar = _mm256_sub_epi32(doe, _mm256_sub_epi32(_mm256_add_epi32(_mm256_mullo_epi32(yoe, _mm256_set1_epi32(365)),
+                                                                                        _mm256_srli_epi32(yoe, 2)), q100));
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i div4 = _mm256_cmpeq_epi32(_mm256_and_si256(yoe, _mm256_set1_epi32(3)), zero);
+        const __m256i centuryNot400 = _mm256_andnot_si256(_mm256_cmpeq_epi32(yoe, zero),
+                                                          _mm256_cmpeq_epi32(yoe, _mm256_mullo_epi32(q100, _mm256_set1_epi32(100))));
+        const __m256i isLeap = _mm256_andnot_si256(centuryNot400, div4);
+        const __m256i isJanFeb = _mm256_cmpgt_epi32(doyMar, _mm256_set1_epi32(305));
+        const __m256i marToDec = _mm256_sub_epi32(_mm256_add_epi32(doyMar, _mm256_set1_epi32(59)), isLeap);
+        const __m256i yday = _mm256_blendv_epi8(marToDec, _mm256_sub_epi32(doyMar, _mm256_set1_epi32(306)), isJanFeb);
+        const __m256i week = _mm256_add_epi32(mulhi_epu32_AVX2(yday, 613566757u), _mm256_set1_epi32(1));
+
+        const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(week), _mm256_extracti128_si256(week, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(words, words));
+    }
+    epochDaysKernel_Scalar(days + i, out + i, n - i);
+}
+
+void convertEpochDaysToWeeks_AVX2(std::span<const int32_t> days, std::span<uint8_t> out) noexcept
+{
+    epochDaysKernel_AVX2(days.data(), out.data(), std::min(days.size(), out.size()));
+}
+
+// The unmasked _mm512_mul_epu32 / _mm512_srli_* of some GCC versions merge
+// into _mm512_undefined_epi32(), which -Wmaybe-uninitialized reports once
+// inlined; the all-lanes maskz forms have a defined source and compile to
+// the same instructions.
+template<unsigned Shift>
+ISO_WEEK_TARGET("avx512f") static inline __m512i srli_epi32_AVX512(__m512i x) noexcept
+{
+    return _mm512_maskz_srli_epi32(0xFFFF, x, Shift);
+}
+
+ISO_WEEK_TARGET("avx512f") static inline __m512i mulhi_epu32_AVX512(__m512i x, uint32_t m) noexcept
+{
+    const __m512i mv = _mm512_set1_epi32(static_cast<int>(m));
+    const __m512i even = _mm512_maskz_srli_epi64(0xFF, _mm512_maskz_mul_epu32(0xFF, x, mv), 32);
+    const __m512i odd = _mm512_maskz_mul_epu32(0xFF, _mm512_maskz_srli_epi64(0xFF, x, 32), mv);
+    return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+}
+
+ISO_WEEK_TARGET("avx512f")
+static void epochDaysKernel_AVX512(const int32_t* days, uint8_t* out, size_t n) noexcept
+{
+    const __m512i seven = _mm512_set1_epi32(7);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i d = _mm512_loadu_si512(days + i);
+        const __mmask16 valid = _mm512_cmpge_epi32_mask(d, _mm512_set1_epi32(EPOCH_SIMD_MIN_DAYS))
+                              & _mm512_cmplt_epi32_mask(d, _mm512_set1_epi32(EPOCH_SIMD_MAX_DAYS));
+        if (valid != 0xFFFF) {
+            epochDaysKernel_Scalar(days + i, out + i, 16);
+            continue;
+        }
+
+        const __m512i z = _mm512_add_epi32(d, _mm512_set1_epi32(719468));
+        const __m512i z2 = _mm512_add_epi32(z, _mm512_set1_epi32(2));
+        const __m512i weekdayIndex = _mm512_sub_epi32(z2, _mm512_mullo_epi32(srli_epi32_AVX512<2>(mulhi_epu32_AVX512(z2, 2454267027u)), seven));
+        const __m512i zth = _mm512_add_epi32(_mm512_sub_epi32(z, weekdayIndex), _mm512_set1_epi32(3));
+
+        const __m512i era = srli_epi32_AVX512<15>(mulhi_epu32_AVX512(zth, 963315389u));
+        const __m512i doe = _mm512_sub_epi32(zth, _mm512_mullo_epi32(era, _mm512_set1_epi32(146097)));
+        const __m512i q36524 = mulhi_epu32_AVX512(doe, 235187u);
+        const __m512i yoeNum = _mm512_sub_epi32(_mm512_add_epi32(_mm512_sub_epi32(doe, mulhi_epu32_AVX512(doe, 2941759u)),
+                                                                 srli_epi32_AVX512<1>(q36524)),
+                                                srli_epi32_AVX512<3>(q36524));
+        const __m512i yoe = mulhi_epu32_AVX512(yoeNum, 11767034u);
+        const __m512i q100 = mulhi_epu32_AVX512(yoe, 42949673u);
+        const __m512i doyMar = _mm512_sub_epi32(doe, _mm512_sub_epi32(_mm512_add_epi32(_mm512_mullo_epi32(yoe, _mm512_set1_epi32(365)),
+                                                                                        srli_epi32_AVX512<2>(yoe)), q100));
+
+        const __m512i zero = _mm512_setzero_si512();
+        const __mmask16 div4 = _mm512_cmpeq_epi32_mask(_mm512_and_si512(yoe, _mm512_set1_epi32(3)), zero);
+        const __mmask16 centuryNot400 = _mm512_cmpneq_epi32_mask(yoe, zero)
+                                      & _mm512_cmpeq_epi32_mask(yoe, _mm512_mullo_epi32(q100, _mm512_set1_epi32(100)));
+        const __mmask16 isLeap = div4 & static_cast<__mmask16>(~centuryNot400);
+        const __mmask16 isJanFeb = _mm512_cmpgt_epi32_mask(doyMar, _mm512_set1_epi32(305));
+        const __m512i afterFeb = _mm512_add_epi32(doyMar, _mm512_set1_epi32(59));
+        const __m512i marToDec = _mm512_mask_add_epi32(afterFeb, isLeap, afterFeb, _mm512_set1_epi32(1));
+        const __m512i yday = _mm512_mask_blend_epi32(isJanFeb, marToDec, _mm512_sub_epi32(doyMar, _mm512_set1_epi32(306)));
+        const __m512i week = _mm512_add_epi32(mulhi_epu32_AVX512(yday, 613566757u), _mm512_set1_epi32(1));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm512_maskz_cvtepi32_epi8(0xFFFF, week));
+    }
+    epochDaysKernel_Scalar(days + i, out + i, n - i);
+}
+
+void convertEpochDaysToWeeks_AVX512(std::span<const int32_t> days, std::span<uint8_t> out) noexcept
+{
+    epochDaysKernel_AVX512(days.data(), out.data(), std::min(days.size(), out.size()));
+}
+
+#endif // ISO_WEEK_X86_SIMD
+
+void convertEpochDaysToWeeks(std::span<const int32_t> days, std::span<uint8_t> out) noexcept
+{
+    static const EpochBatchFunc<int32_t> kernel = [] {
+        [[maybe_unused]] const CpuFeatures& cpu = CpuFeatures::get();
+#ifdef ISO_WEEK_X86_SIMD
+        if (cpu.avx512f) {
+            return EpochBatchFunc<int32_t>(convertEpochDaysToWeeks_AVX512);
+        }
+        if (cpu.avx2) {
+            return EpochBatchFunc<int32_t>(convertEpochDaysToWeeks_AVX2);
+        }
+#endif
+        return EpochBatchFunc<int32_t>(convertEpochDaysToWeeks_Scalar);
+    }();
+    kernel(days, out);
+}
+
+// Sorted epoch days through IsoWeekCursor: the first day is placed with
+// at(), every later one with advance() by the gap to its predecessor. Gaps
+// of more than a year (or backwards) start over with at().
+void convertSortedEpochDaysToWeeks(std::span<const int32_t> days, std::span<uint8_t> out) noexcept
+{
+    const size_t n = std::min(days.size(), out.size());
+    IsoWeekCursor cursor;
+    for (size_t i = 0; i < n; ++i) {
+        const int64_t gap = i ? int64_t{days[i]} - days[i - 1] : -1;
+        if (gap >= 0 && gap <= 366) {
+            out[i] = cursor.advance(static_cast<int>(gap)).week;
+        } else {
+            const YearDay d = civilYearDayFromDays(days[i]);
+            out[i] = cursor.at(static_cast<int>(d.year), d.yday).week;
+        }
+    }
+}
+
+// Seconds are floored to days in fixed-size blocks and fed to the dispatched
+// day kernel; a block whose day numbers do not fit int32 is converted scalar.
+void convertEpochSecondsToWeeks(std::span<const int64_t> seconds, std::span<uint8_t> out) noexcept
+{
+    constexpr size_t BLOCK = 256;
+    int32_t days[BLOCK];
+    const size_t n = std::min(seconds.size(), out.size());
+    for (size_t offset = 0; offset < n; offset += BLOCK) {
+        const size_t count = std::min(BLOCK, n - offset);
+        bool fits = true;
+        for (size_t i = 0; i < count; ++i) {
+            const int64_t d = floorDaysFromSeconds(seconds[offset + i]);
+            fits &= (d >= INT32_MIN) & (d <= INT32_MAX);
+            days[i] = static_cast<int32_t>(d);
+        }
+        if (fits) {
+            convertEpochDaysToWeeks(std::span<const int32_t>(days, count), out.subspan(offset, count));
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                out[offset + i] = static_cast<uint8_t>(convertEpochSecondsToWeek(seconds[offset + i]));
+            }
+        }
+    }
+}
+
+// Walks every day of [minYear, maxYear] and checks the epoch path against
+// gmtime_r() (year/yday) and against Original on the resulting struct tm.
+// Returns the number of mismatches.
+size_t verifyEpochConversions(int minYear, int maxYear, bool verbose)
+{
+    const int64_t firstDay = daysFromYearDay(minYear, 0);
+    const int64_t lastDay = daysFromYearDay(maxYear + 1, 0) - 1;
+    size_t mismatches = 0;
+
+    auto report = [&](const char* what, int64_t day, int expected, int actual) {
+        ++mismatches;
+        if (verbose && mismatches <= 5) {
+            std::cout << "\n    EPOCH MISMATCH (" << what << "): day=" << day
+                      << " expected=" << expected << " actual=" << actual;
+        }
+    };
+
+    std::vector<int32_t> dayColumn;
+    std::vector<int64_t> secondColumn;
+    std::vector<uint8_t> expectedWeeks;
+    for (int64_t day = firstDay; day <= lastDay; ++day) {
+        const YearDay yd = civilYearDayFromDays(day);
+        struct tm times;
+        std::memset(&times, 0, sizeof(times));
+        times.tm_year = static_cast<int>(yd.year) - 1900;
+        times.tm_yday = yd.yday;
+        const int expected = convertGregorianDateToWeekDate_Original(times);
+
+        // Last second of the day exercises flooring for pre-1970 timestamps.
+        const int64_t seconds = day * 86400 + 86399;
+#ifndef _WIN32
+        const time_t t = static_cast<time_t>(seconds);
+        struct tm utc;
+        if (gmtime_r(&t, &utc)) {
+            if (utc.tm_year != times.tm_year || utc.tm_yday != times.tm_yday) {
+                report("gmtime_r yday", day, utc.tm_yday, yd.yday);
+            }
+        }
+#endif
+        if (convertEpochDaysToWeek(day) != expected) {
+            report("days", day, expected, convertEpochDaysToWeek(day));
+        }
+        if (convertEpochSecondsToWeek(seconds) != expected) {
+            report("seconds", day, expected, convertEpochSecondsToWeek(seconds));
+        }
+        if (!(convertEpochDaysToIsoWeekDate(day) == convertGregorianDateToIsoWeekDate_Original(times))) {
+            report("full", day, expected, convertEpochDaysToIsoWeekDate(day).week);
+        }
+        dayColumn.push_back(static_cast<int32_t>(day));
+        secondColumn.push_back(seconds);
+        expectedWeeks.push_back(static_cast<uint8_t>(expected));
+    }
+
+    std::vector<uint8_t> weeks(dayColumn.size());
+    auto checkBatch = [&](const char* what) {
+        for (size_t i = 0; i < weeks.size(); ++i) {
+            if (weeks[i] != expectedWeeks[i]) {
+                report(what, dayColumn[i], expectedWeeks[i], weeks[i]);
+            }
+        }
+    };
+    convertEpochDaysToWeeks_Scalar(dayColumn, weeks);
+    checkBatch("batch scalar");
+#ifdef ISO_WEEK_X86_SIMD
+    if (CpuFeatures::get().avx2) {
+        convertEpochDaysToWeeks_AVX2(dayColumn, weeks);
+        checkBatch("batch AVX2");
+    }
+    if (CpuFeatures::get().avx512f) {
+        convertEpochDaysToWeeks_AVX512(dayColumn, weeks);
+        checkBatch("batch AVX512");
+    }
+#endif
+    convertEpochSecondsToWeeks(secondColumn, weeks);
+    checkBatch("batch seconds");
+
+    return mismatches;
+}
+
+// ============================================================================
+// REVERSE CONVERSION (ISO year, week, weekday -> Gregorian date)
+// ============================================================================
+// Week 1 starts on the Monday on or before Jan 4: Jan 1 itself when it is a
+// Monday, otherwise the Monday before Jan 1 when Jan 1 falls on Tuesday to
+// Thursday, and the Monday after it when it falls on Friday to Sunday. Every
+// other date is that Monday plus 7 * (week - 1) + (weekday - 1) days, which
+// can run into the previous or the next calendar year.
+//
+// Results are Jan-based (year, zero-based yday), as in tm_year + 1900 and
+// tm_yday, or days since 1970-01-01. The inputs must be valid ISO week dates.
+// Out-of-range weeks or weekdays give the same linear extrapolation in every
+// kernel.
+
+// Days from 0001-01-01 (a Monday in the proleptic Gregorian calendar) to 1970-01-01.
+constexpr int32_t EPOCH_DAYS_FROM_0001 = 719162;
+
+// Branchy, on the V5 year table.
+constexpr YearDay convertIsoWeekDateToYearDay_Scalar(IsoWeekDate d) noexcept
+{
+    const int y = d.isoYear;
+    const int jan1Offset = (yearInfo(y) & 7) - 1;                 // 0 = Monday
+    int yday = 7 * (d.week - 1) + (d.weekday - 1) - jan1Offset;
+    if (jan1Offset >= 4) {
+        yday += 7;
+    }
+    if (yday < 0) {
+        return {y - 1, yday + daysInYear(y - 1)};
+    }
+    const int length = daysInYear(y);
+    if (yday >= length) {
+        return {y + 1, yday - length};
+    }
+    return {y, yday};
+}
+
+// Same table, year carry done with masks.
+constexpr YearDay convertIsoWeekDateToYearDay_Branchless(IsoWeekDate d) noexcept
+{
+    const int y = d.isoYear;
+    const unsigned info = yearInfo(y);
+    const int jan1Offset = static_cast<int>(info & 7) - 1;
+    const int yday = 7 * d.week + d.weekday - 8 - jan1Offset + 7 * (jan1Offset >= 4);
+    const int length = 365 + static_cast<int>((info >> 3) & 1);
+    const int prevLength = 365 + static_cast<int>((yearInfo(y - 1) >> 3) & 1);
+    const int before = yday < 0;
+    const int after = yday >= length;
+    return {y - before + after, yday + before * prevLength - after * length};
+}
+
+// Days since 1970-01-01; no year carry needed.
+constexpr int64_t convertIsoWeekDateToEpochDays(IsoWeekDate d) noexcept
+{
+    const int64_t jan1 = daysFromYearDay(d.isoYear, 0);
+    const int64_t r = (jan1 + 3) % 7;                             // 1970-01-01 was a Thursday
+    const int64_t jan1Offset = r + 7 * (r < 0);                   // 0 = Monday
+    return jan1 - jan1Offset + 7 * (jan1Offset >= 4) + 7 * (d.week - 1) + (d.weekday - 1);
+}
+
+// Number of ISO weeks (52 or 53) in isoYear.
+constexpr int isoWeeksInYear(int isoYear) noexcept
+{
+    return 52 + static_cast<int>((yearInfo(isoYear + 1) >> 4) & 1);
+}
+
+// Monday and Sunday of one ISO week, as days since 1970-01-01.
+struct EpochDayRange {
+    int64_t first;
+    int64_t last;
+};
+
+constexpr EpochDayRange isoWeekEpochDays(int isoYear, int week) noexcept
+{
+    const int64_t monday = convertIsoWeekDateToEpochDays(makeIsoWeekDate(isoYear, week, 1));
+    return {monday, monday + 6};
+}
+
+// Batch kernels take packed ISO week dates (packIsoWeekDate) and process
+// min(in.size(), out.size()) elements.
+using ReverseEpochBatchFunc = void (*)(std::span<const uint32_t>, std::span<int32_t>) noexcept;
+
+static inline void reverseEpochKernel_Scalar(const uint32_t* packed, int32_t* out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<int32_t>(convertIsoWeekDateToEpochDays(unpackIsoWeekDate(packed[i])));
+    }
+}
+
+void convertIsoWeekDatesToEpochDays_Scalar(std::span<const uint32_t> packed, std::span<int32_t> out) noexcept
+{
+    reverseEpochKernel_Scalar(packed.data(), out.data(), std::min(packed.size(), out.size()));
+}
+
+// Year/yday columns in the layout convertWeekDates() reads.
+void convertIsoWeekDatesToYearDays(std::span<const uint32_t> packed, std::span<int16_t> years,
+                                   std::span<int16_t> ydays) noexcept
+{
+    const size_t n = std::min({packed.size(), years.size(), ydays.size()});
+    for (size_t i = 0; i < n; ++i) {
+        const YearDay d = convertIsoWeekDateToYearDay_Branchless(unpackIsoWeekDate(packed[i]));
+        years[i] = static_cast<int16_t>(d.year);
+        ydays[i] = static_cast<int16_t>(d.yday);
+    }
+}
+
+#ifdef ISO_WEEK_X86_SIMD
+
+// 32-bit lanes over ISO years 1-32767; blocks with another year go to the
+// scalar kernel. With y1 = year - 1, Jan 1 is d1 = 365 * y1 + y1 / 4 - y1 / 100
+// + y1 / 400 days after 0001-01-01 and its weekday is d1 % 7 (0 = Monday):
+//   y1 / 100   M = 42949673,   s = 0   (y1 < 2^30)
+//   d1 / 7     M = 2454267027, s = 2   (d1 < 2^31)
+ISO_WEEK_TARGET("avx2")
+static void reverseEpochKernel_AVX2(const uint32_t* packed, int32_t* out, size_t n) noexcept
+{
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed + i));
+        const __m256i year = _mm256_srli_epi32(p, 16);
+        const __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(year, _mm256_setzero_si256()),
+                                               _mm256_cmpgt_epi32(_mm256_set1_epi32(32768), year));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            reverseEpochKernel_Scalar(packed + i, out + i, 8);
+            continue;
+        }
+
+        const __m256i y1 = _mm256_sub_epi32(year, _mm256_set1_epi32(1));
+        const __m256i q100 = mulhi_epu32_AVX2(y1, 42949673u);
+        const __m256i d1 = _mm256_add_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_mullo_epi32(y1, _mm256_set1_epi32(365)),
+                                                                              _mm256_srli_epi32(y1, 2)), q100),
+                                            _mm256_srli_epi32(q100, 2));
+        const __m256i q7 = _mm256_srli_epi32(mulhi_epu32_AVX2(d1, 2454267027u), 2);
+        const __m256i jan1Offset = _mm256_sub_epi32(d1, _mm256_mullo_epi32(q7, _mm256_set1_epi32(7)));
+        const __m256i nextMonday = _mm256_and_si256(_mm256_cmpgt_epi32(jan1Offset, _mm256_set1_epi32(3)), _mm256_set1_epi32(7));
+        const __m256i week = _mm256_and_si256(_mm256_srli_epi32(p, 8), byteMask);
+        const __m256i weekday = _mm256_and_si256(p, byteMask);
+        const __m256i within = _mm256_add_epi32(_mm256_mullo_epi32(week, _mm256_set1_epi32(7)), weekday);
+        const __m256i days = _mm256_add_epi32(_mm256_add_epi32(_mm256_sub_epi32(d1, jan1Offset), nextMonday),
+                                              _mm256_sub_epi32(within, _mm256_set1_epi32(8 + EPOCH_DAYS_FROM_0001)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), days);
+    }
+    reverseEpochKernel_Scalar(packed + i, out + i, n - i);
+}
+
+void convertIsoWeekDatesToEpochDays_AVX2(std::span<const uint32_t> packed, std::span<int32_t> out) noexcept
+{
+    reverseEpochKernel_AVX2(packed.data(), out.data(), std::min(packed.size(), out.size()));
+}
+
+ISO_WEEK_TARGET("avx512f")
+static void reverseEpochKernel_AVX512(const uint32_t* packed, int32_t* out, size_t n) noexcept
+{
+    const __m512i byteMask = _mm512_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i p = _mm512_loadu_si512(packed + i);
+        const __m512i year = srli_epi32_AVX512<16>(p);
+        const __mmask16 valid = _mm512_cmpgt_epi32_mask(year, _mm512_setzero_si512())
+                              & _mm512_cmplt_epi32_mask(year, _mm512_set1_epi32(32768));
+        if (valid != 0xFFFF) {
+            reverseEpochKernel_Scalar(packed + i, out + i, 16);
+            continue;
+        }
+
+        const __m512i y1 = _mm512_sub_epi32(year, _mm512_set1_epi32(1));
+        const __m512i q100 = mulhi_epu32_AVX512(y1, 42949673u);
+        const __m512i d1 = _mm512_add_epi32(_mm512_sub_epi32(_mm512_add_epi32(_mm512_mullo_epi32(y1, _mm512_set1_epi32(365)),
+                                                                              srli_epi32_AVX512<2>(y1)), q100),
+                                            srli_epi32_AVX512<2>(q100));
+        const __m512i q7 = srli_epi32_AVX512<2>(mulhi_epu32_AVX512(d1, 2454267027u));
+        const __m512i jan1Offset = _mm512_sub_epi32(d1, _mm512_mullo_epi32(q7, _mm512_set1_epi32(7)));
+        const __mmask16 nextMonday = _mm512_cmpgt_epi32_mask(jan1Offset, _mm512_set1_epi32(3));
+        const __m512i week = _mm512_and_si512(srli_epi32_AVX512<8>(p), byteMask);
+        const __m512i weekday = _mm512_and_si512(p, byteMask);
+        const __m512i within = _mm512_add_epi32(_mm512_mullo_epi32(week, _mm512_set1_epi32(7)), weekday);
+        const __m512i monday = _mm512_sub_epi32(d1, jan1Offset);
+        const __m512i week1 = _mm512_mask_add_epi32(monday, nextMonday, monday, _mm512_set1_epi32(7));
+        const __m512i days = _mm512_add_epi32(week1, _mm512_sub_epi32(within, _mm512_set1_epi32(8 + EPOCH_DAYS_FROM_0001)));
+        _mm512_storeu_si512(out + i, days);
+    }
+    reverseEpochKernel_Scalar(packed + i, out + i, n - i);
+}
+
+void convertIsoWeekDatesToEpochDays_AVX512(std::span<const uint32_t> packed, std::span<int32_t> out) noexcept
+{
+    reverseEpochKernel_AVX512(packed.data(), out.data(), std::min(packed.size(), out.size()));
+}
+
+#endif // ISO_WEEK_X86_SIMD
+
+void convertIsoWeekDatesToEpochDays(std::span<const uint32_t> packed, std::span<int32_t> out) noexcept
+{
+    static const ReverseEpochBatchFunc kernel = [] {
+        [[maybe_unused]] const CpuFeatures& cpu = CpuFeatures::get();
+#ifdef ISO_WEEK_X86_SIMD
+        if (cpu.avx512f) {
+            return ReverseEpochBatchFunc(convertIsoWeekDatesToEpochDays_AVX512);
+        }
+        if (cpu.avx2) {
+            return ReverseEpochBatchFunc(convertIsoWeekDatesToEpochDays_AVX2);
+        }
+#endif
+        return ReverseEpochBatchFunc(convertIsoWeekDatesToEpochDays_Scalar);
+    }();
+    kernel(packed, out);
+}
+
+// Round trip over every day of [minYear, maxYear]: Original's ISO week date
+// of the day must map back to the same day through every reverse entry point
+// (per-call and batch). Returns the number of mismatches.
+size_t verifyReverseConversions(int minYear, int maxYear, bool verbose)
+{
+    const int64_t firstDay = daysFromYearDay(minYear, 0);
+    const int64_t lastDay = daysFromYearDay(maxYear + 1, 0) - 1;
+    size_t mismatches = 0;
+
+    auto report = [&](const char* what, int64_t day, int64_t actual) {
+        ++mismatches;
+        if (verbose && mismatches <= 5) {
+            std::cout << "\n    REVERSE MISMATCH (" << what << "): day=" << day << " actual=" << actual;
+        }
+    };
+
+    std::vector<uint32_t> packed;
+    packed.reserve(static_cast<size_t>(lastDay - firstDay + 1));
+    for (int64_t day = firstDay; day <= lastDay; ++day) {
+        const YearDay yd = civilYearDayFromDays(day);
+        const IsoWeekDate iso = convertGregorianDateToIsoWeekDate_Original(timeStructFor(static_cast<int>(yd.year), yd.yday));
+        packed.push_back(packIsoWeekDate(iso));
+
+        const YearDay branchy = convertIsoWeekDateToYearDay_Scalar(iso);
+        const YearDay branchless = convertIsoWeekDateToYearDay_Branchless(iso);
+        if (branchy.year != yd.year || branchy.yday != yd.yday) {
+            report("scalar", day, daysFromYearDay(branchy.year, branchy.yday));
+        }
+        if (branchless.year != yd.year || branchless.yday != yd.yday) {
+            report("branchless", day, daysFromYearDay(branchless.year, branchless.yday));
+        }
+        if (convertIsoWeekDateToEpochDays(iso) != day) {
+            report("epoch days", day, convertIsoWeekDateToEpochDays(iso));
+        }
+        const EpochDayRange week = isoWeekEpochDays(iso.isoYear, iso.week);
+        if (day < week.first || day > week.last || iso.week > isoWeeksInYear(iso.isoYear)) {
+            report("week range", day, week.first);
+        }
+    }
+
+    std::vector<int32_t> days(packed.size());
+    std::vector<int16_t> years(packed.size());
+    std::vector<int16_t> ydays(packed.size());
+    auto checkDays = [&](const char* what) {
+        for (size_t i = 0; i < days.size(); ++i) {
+            if (days[i] != firstDay + static_cast<int64_t>(i)) {
+                report(what, firstDay + static_cast<int64_t>(i), days[i]);
+            }
+        }
+    };
+    convertIsoWeekDatesToEpochDays_Scalar(packed, days);
+    checkDays("batch scalar");
+#ifdef ISO_WEEK_X86_SIMD
+    if (CpuFeatures::get().avx2) {
+        convertIsoWeekDatesToEpochDays_AVX2(packed, days);
+        checkDays("batch AVX2");
+    }
+    if (CpuFeatures::get().avx512f) {
+        convertIsoWeekDatesToEpochDays_AVX512(packed, days);
+        checkDays("batch AVX-512");
+    }
+#endif
+    convertIsoWeekDatesToYearDays(packed, years, ydays);
+    for (size_t i = 0; i < packed.size(); ++i) {
+        const int64_t day = firstDay + static_cast<int64_t>(i);
+        if (daysFromYearDay(years[i], ydays[i]) != day) {
+            report("batch year/yday", day, daysFromYearDay(years[i], ydays[i]));
+        }
+    }
+    return mismatches;
+}
+
+// ============================================================================
+// YEAR-RANGE SPECIALIZATION
+// ============================================================================
+// weekNumber_Range<MinYear, MaxYear> is V4 for callers that guarantee
+// MinYear <= y <= MaxYear. Each /100 and /400 term is checked over the range
+// at compile time and dropped when it cannot change a result:
+//   - y_1/100 - y_1/400 in the Jan-1 weekday folds to a constant when it does
+//     not vary (1900-2098: always 15, because 2000 is a 400-year leap year)
+//   - the leap tests reduce to (y & 3) == 0 when no year they can see is a
+//     common century year; the previous year's leap bit only matters when
+//     Jan 1 is a Saturday, so 1900 does not block it for 1901
+// With every term dropped (1901-2099) the formula is the Julian one.
+template<int MinYear, int MaxYear>
+struct YearRange {
+    static_assert(1 <= MinYear && MinYear <= MaxYear, "year range must be positive and non-empty");
+
+    static constexpr int centuryTerm(int y_1) noexcept { return y_1 / 100 - y_1 / 400; }
+    static constexpr bool isLeap(int y) noexcept { return !(y & 3) && ((y % 100) || !(y % 400)); }
+    static constexpr int jan1Weekday(int y) noexcept
+    {
+        return 1 + ((y - 1 + (y - 1) / 4 - centuryTerm(y - 1)) % 7);
+    }
+
+    static constexpr int CENTURY_TERM = centuryTerm(MinYear - 1);
+    static constexpr bool centuryConstant = [] {
+        for (int y = MinYear; y <= MaxYear; ++y) {
+            if (centuryTerm(y - 1) != CENTURY_TERM) {
+                return false;
+            }
+        }
+        return true;
+    }();
+    static constexpr bool leapIsMod4 = [] {
+        for (int y = MinYear; y <= MaxYear; ++y) {
+            if (isLeap(y) != !(y & 3)) {
+                return false;
+            }
+        }
+        return true;
+    }();
+    static constexpr bool prevLeapIsMod4 = [] {
+        for (int y = MinYear; y <= MaxYear; ++y) {
+            if (jan1Weekday(y) == 6 && isLeap(y - 1) != !((y - 1) & 3)) {
+                return false;
+            }
+        }
+        return true;
+    }();
+};
+
+template<int MinYear, int MaxYear>
+constexpr int weekNumber_Range(int y, int dayOfYear) noexcept
+{
+    using Range = YearRange<MinYear, MaxYear>;
+    const int y_1 = y - 1;
+    const unsigned u_1 = static_cast<unsigned>(y_1);
+    unsigned centuries;
+    if constexpr (Range::centuryConstant) {
+        centuries = static_cast<unsigned>(Range::CENTURY_TERM);
+    } else {
+        centuries = u_1 / 100 - u_1 / 400;
+    }
+    const int jan1Weekday = 1 + static_cast<int>((u_1 + u_1 / 4 - centuries) % 7);
+    const int weekday = 1 + ((dayOfYear + jan1Weekday - 2) % 7);
+    const int isPrevYear = (dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4);
+    int prevYearLeap;
+    if constexpr (Range::prevLeapIsMod4) {
+        prevYearLeap = (y_1 & 3) == 0;
+    } else {
+        prevYearLeap = ((y_1 & 3) == 0) & (((y_1 % 100) != 0) | ((y_1 % 400) == 0));
+    }
+    int isLeap;
+    if constexpr (Range::leapIsMod4) {
+        isLeap = (y & 3) == 0;
+    } else {
+        isLeap = ((y & 3) == 0) & (((y % 100) != 0) | ((y % 400) == 0));
+    }
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    const int prevYearWeek = 52 + prevIs53;
+    const int daysInYear = 365 + isLeap;
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const int j = dayOfYear + (7 - weekday) + (jan1Weekday - 1);
+    const int currYearWeek = (j / 7) - (jan1Weekday > 4);
+    return (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
+
+template<int MinYear, int MaxYear>
+constexpr int convertGregorianDateToWeekDate_Range(const struct tm& times) noexcept
+{
+    return weekNumber_Range<MinYear, MaxYear>(times.tm_year + 1900, times.tm_yday + 1);
+}
+
+static_assert(YearRange<1901, 2099>::centuryConstant && YearRange<1901, 2099>::leapIsMod4
+              && YearRange<1901, 2099>::prevLeapIsMod4, "1901-2099 should drop every century term");
+static_assert(!YearRange<1, 9999>::centuryConstant && !YearRange<1, 9999>::leapIsMod4);
+
+// ============================================================================
+// COMPILE-TIME CHECKS
+// ============================================================================
+// Every scalar variant is constexpr; these dates around ISO year boundaries
+// (53-week years, Dec 29-31 in week 1, Jan 1-3 in week 52/53, century years)
+// are checked for all of them when main.cpp is compiled.
+struct KnownIsoWeekDate {
+    int year;
+    int yday;                           // Zero-based
+    IsoWeekDate expected;
+};
+
+constexpr KnownIsoWeekDate KNOWN_ISO_WEEK_DATES[] = {
+    {1600,   0, {1599, 52, 6}},         // 1600-01-01
+    {1900, 364, {1901, 1, 1}},          // 1900-12-31
+    {1901,   0, {1901, 1, 2}},          // 1901-01-01
+    {2000,  59, {2000, 9, 2}},          // 2000-02-29
+    {2000, 365, {2000, 52, 7}},         // 2000-12-31
+    {2004, 365, {2004, 53, 5}},         // 2004-12-31
+    {2005,   0, {2004, 53, 6}},         // 2005-01-01
+    {2005,   1, {2004, 53, 7}},         // 2005-01-02
+    {2005, 364, {2005, 52, 6}},         // 2005-12-31
+    {2007,   0, {2007, 1, 1}},          // 2007-01-01
+    {2007, 363, {2007, 52, 7}},         // 2007-12-30
+    {2007, 364, {2008, 1, 1}},          // 2007-12-31
+    {2008,   0, {2008, 1, 2}},          // 2008-01-01
+    {2008, 362, {2008, 52, 7}},         // 2008-12-28
+    {2008, 363, {2009, 1, 1}},          // 2008-12-29
+    {2008, 365, {2009, 1, 3}},          // 2008-12-31
+    {2009, 364, {2009, 53, 4}},         // 2009-12-31
+    {2010,   2, {2009, 53, 7}},         // 2010-01-03
+    {2010,   3, {2010, 1, 1}},          // 2010-01-04
+    {2020, 365, {2020, 53, 4}},         // 2020-12-31
+    {2021,   2, {2020, 53, 7}},         // 2021-01-03
+    {2099, 364, {2099, 53, 4}},         // 2099-12-31
+    {2100,   0, {2099, 53, 5}},         // 2100-01-01
+    {2400, 365, {2400, 52, 7}},         // 2400-12-31
+};
+
+// Week-only functions are checked on .week, full ones on all three fields.
+// Dates outside [minYear, maxYear] are skipped (for the range template).
+template<auto Func>
+constexpr bool matchesKnownDates(int minYear = 1, int maxYear = 9999) noexcept
+{
+    for (const KnownIsoWeekDate& known : KNOWN_ISO_WEEK_DATES) {
+        if (known.year < minYear || known.year > maxYear) {
+            continue;
+        }
+        const auto r = Func(timeStructFor(known.year, known.yday));
+        if constexpr (std::is_same_v<std::remove_const_t<decltype(r)>, IsoWeekDate>) {
+            if (!(r == known.expected)) {
+                return false;
+            }
+        } else if (r != known.expected.week) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_Original>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V1>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V2>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V3>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V4>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V5>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_V6>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_Original>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_V1>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_V2>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_V3>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_V4>());
+static_assert(matchesKnownDates<convertGregorianDateToIsoWeekDate_V5>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_Range<1, 9999>>());
+static_assert(matchesKnownDates<convertGregorianDateToWeekDate_Range<1901, 2099>>(1901, 2099));
+
+constexpr bool epochMatchesKnownDates() noexcept
+{
+    for (const KnownIsoWeekDate& known : KNOWN_ISO_WEEK_DATES) {
+        const int64_t day = daysFromYearDay(known.year, known.yday);
+        if (!(convertEpochDaysToIsoWeekDate(day) == known.expected)
+            || convertEpochSecondsToWeek(day * 86400 + 86399) != known.expected.week) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(epochMatchesKnownDates());
+
+constexpr bool reverseMatchesKnownDates() noexcept
+{
+    for (const KnownIsoWeekDate& known : KNOWN_ISO_WEEK_DATES) {
+        const YearDay branchy = convertIsoWeekDateToYearDay_Scalar(known.expected);
+        const YearDay branchless = convertIsoWeekDateToYearDay_Branchless(known.expected);
+        if (branchy.year != known.year || branchy.yday != known.yday
+            || branchless.year != known.year || branchless.yday != known.yday
+            || convertIsoWeekDateToEpochDays(known.expected) != daysFromYearDay(known.year, known.yday)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(reverseMatchesKnownDates());
+static_assert(daysFromYearDay(1, 0) == -EPOCH_DAYS_FROM_0001);
+static_assert(isoWeeksInYear(2004) == 53 && isoWeeksInYear(2005) == 52 && isoWeeksInYear(2020) == 53);
+static_assert(isoWeekEpochDays(2009, 53).first == daysFromYearDay(2009, 361));
+
+// The 1901-2099 specialization agrees with V4 on the first and last week and
+// one mid-year day of every year of its range; the dropped terms only decide
+// the Jan-1 weekday and the year lengths. --verify-exhaustive covers the rest.
+constexpr bool rangeMatchesV4() noexcept
+{
+    for (int y = 1901; y <= 2099; ++y) {
+        for (int day : {1, 2, 3, 4, 5, 6, 7, 183, daysInYear(y) - 6, daysInYear(y) - 5, daysInYear(y) - 4,
+                        daysInYear(y) - 3, daysInYear(y) - 2, daysInYear(y) - 1, daysInYear(y)}) {
+            if (weekNumber_Range<1901, 2099>(y, day) != weekNumber_V4(y, day)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(rangeMatchesV4());
+
+static_assert(ydayFromDate(2000, 2, 29) == 59 && ydayFromDate(2100, 2, 29) == -1 && ydayFromDate(2024, 12, 31) == 365);
+
+// ============================================================================
+// COLUMNAR FILES (mmap)
+// ============================================================================
+// Raw columns without a header: little-endian int32 epoch days or int64 epoch
+// seconds in, one ISO week byte per record out. Both files are mapped shared;
+// the input is advised MADV_SEQUENTIAL and the output is sized up front and
+// written in place, so the batch kernels run directly on page-cache memory.
+// Workers pull FILE_CHUNK_RECORDS-record chunks from a shared counter.
+// Records outside 0001-01-01 .. 9999-12-31 (epochDaysInRange,
+// epochSecondsInRange) get week 0 and are counted.
+constexpr size_t FILE_CHUNK_RECORDS = size_t(1) << 20;     // A page multiple for every column width
+constexpr size_t FILE_VALIDATE_RECORDS = size_t(1) << 15;  // Range-checked while still in cache
+constexpr size_t FILE_SAMPLE_STRIDE = 4093;                 // Spot-check one record in this many
+
+struct FileConversionReport {
+    std::string error;                  // Empty on success
+    size_t records = 0;
+    size_t inputBytes = 0;
+    size_t outputBytes = 0;
+    size_t threads = 0;
+    size_t sampled = 0;                 // In-range records compared with the scalar path
+    size_t mismatches = 0;              // Sampled records that disagree with the scalar path
+    size_t outOfRange = 0;              // Records written as week 0
+    double convertSeconds = 0.0;        // Page faults and kernels, from first touch to last chunk
+    double flushSeconds = 0.0;          // msync of the output mapping
+
+    double gbPerSecond() const {
+        return convertSeconds > 0.0 ? static_cast<double>(inputBytes + outputBytes) / convertSeconds / 1e9 : 0.0;
+    }
+};
+
+// Number of workers forEachFileChunk() starts for records and threads.
+inline size_t fileChunkWorkers(size_t records, size_t threads) noexcept
+{
+    return std::clamp<size_t>(threads, 1, std::max<size_t>(1, (records + FILE_CHUNK_RECORDS - 1) / FILE_CHUNK_RECORDS));
+}
+
+// Runs fn(worker, begin, end, chunkIndex) over [0, records) in
+// FILE_CHUNK_RECORDS chunks on fileChunkWorkers(records, threads) workers
+// (the calling thread is worker 0) and returns after all of them are joined.
+template<typename Fn>
+void forEachFileChunkOnWorkers(size_t records, size_t threads, Fn&& fn)
+{
+    const size_t chunks = (records + FILE_CHUNK_RECORDS - 1) / FILE_CHUNK_RECORDS;
+    threads = fileChunkWorkers(records, threads);
+    std::atomic<size_t> nextChunk{0};
+    auto worker = [&](size_t w) {
+        for (size_t c; (c = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks; ) {
+            const size_t begin = c * FILE_CHUNK_RECORDS;
+            fn(w, begin, std::min(begin + FILE_CHUNK_RECORDS, records), c);
+        }
+    };
+    std::vector<std::jthread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+}
+
+// Runs fn(begin, end, chunkIndex) over [0, records) in FILE_CHUNK_RECORDS
+// chunks on up to threads workers (the calling thread included).
+template<typename Fn>
+void forEachFileChunk(size_t records, size_t threads, Fn&& fn)
+{
+    forEachFileChunkOnWorkers(records, threads, [&fn](size_t, size_t begin, size_t end, size_t chunk) {
+        fn(begin, end, chunk);
+    });
+}
+
+#ifdef __linux__
+// A file descriptor plus a shared mapping of the whole file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile()
+    {
+        if (base) {
+            munmap(base, bytes);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // Maps an existing file read-only. Returns an error message, empty on success.
+    std::string openRead(const std::string& path)
+    {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errorText("open", path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            return errorText("fstat", path);
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        return map(PROT_READ, path);
+    }
+
+    // Creates (or truncates) path with size bytes and maps it read-write.
+    std::string create(const std::string& path, size_t size)
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return errorText("open", path);
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            return errorText("ftruncate", path);
+        }
+        bytes = size;
+        return map(PROT_READ | PROT_WRITE, path);
+    }
+
+    void advise(int advice) const noexcept
+    {
+        if (base) {
+            madvise(base, bytes, advice);
+        }
+    }
+
+    std::string sync(const std::string& path) const
+    {
+        if (base && msync(base, bytes, MS_SYNC) != 0) {
+            return errorText("msync", path);
+        }
+        return {};
+    }
+
+    std::byte* data() const noexcept { return static_cast<std::byte*>(base); }
+    size_t size() const noexcept { return bytes; }
+
+private:
+    int fd = -1;
+    void* base = nullptr;
+    size_t bytes = 0;
+
+    std::string map(int protection, const std::string& path)
+    {
+        if (bytes == 0) {
+            return {};                  // mmap rejects a zero length; an empty file is an empty column
+        }
+        void* p = mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            return errorText("mmap", path);
+        }
+        base = p;
+        return {};
+    }
+
+    static std::string errorText(const char* call, const std::string& path)
+    {
+        const int err = errno;
+        return path + ": " + call + " failed (" + std::strerror(err) + ")";
+    }
+};
+#endif
+
+// Writes records uniform dates of [minYear, maxYear] (seconds: uniform time of
+// day as well). The content depends only on records, format and the year range.
+// Returns an error message, empty on success.
+std::string generateColumnFile(const std::string& path, size_t records, BenchmarkConfig::FileFormat format,
+                               int minYear, int maxYear, size_t threads)
+{
+#ifdef __linux__
+    if constexpr (std::endian::native != std::endian::little) {
+        return "column files are little-endian; this host is not";
+    }
+    MappedFile file;
+    if (std::string error = file.create(path, records * fileRecordBytes(format)); !error.empty()) {
+        return error;
+    }
+    const int64_t firstDay = daysFromYearDay(minYear, 0);
+    const int64_t lastDay = daysFromYearDay(maxYear + 1, 0) - 1;
+    forEachFileChunk(records, threads, [&](size_t begin, size_t end, size_t chunk) {
+        std::seed_seq seed{uint32_t(42), static_cast<uint32_t>(chunk), static_cast<uint32_t>(uint64_t(chunk) >> 32)};
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int64_t> dayDist(firstDay, lastDay);
+        if (format == BenchmarkConfig::FileFormat::EpochSeconds) {
+            std::uniform_int_distribution<int64_t> secondDist(0, 86399);
+            int64_t* out = reinterpret_cast<int64_t*>(file.data());
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = dayDist(gen) * 86400 + secondDist(gen);
+            }
+        } else {
+            int32_t* out = reinterpret_cast<int32_t*>(file.data());
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = static_cast<int32_t>(dayDist(gen));
+            }
+        }
+    });
+    return file.sync(path);
+#else
+    (void)path; (void)records; (void)format; (void)minYear; (void)maxYear; (void)threads;
+    return "column files need mmap (Linux only)";
+#endif
+}
+
+inline bool epochInputInRange(int32_t days) noexcept { return epochDaysInRange(days); }
+inline bool epochInputInRange(int64_t seconds) noexcept { return epochSecondsInRange(seconds); }
+
+// Converts records with the dispatched batch kernel, then sets the week of
+// every out-of-range record to 0. Returns the number of those.
+template<typename T>
+size_t convertCheckedEpochBlock(std::span<const T> records, std::span<uint8_t> weeks) noexcept
+{
+    if constexpr (std::is_same_v<T, int64_t>) {
+        convertEpochSecondsToWeeks(records, weeks);
+    } else {
+        convertEpochDaysToWeeks(records, weeks);
+    }
+    size_t rejected = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const bool inRange = epochInputInRange(records[i]);
+        rejected += !inRange;
+        weeks[i] = inRange ? weeks[i] : 0;
+    }
+    return rejected;
+}
+
+// Converts inputPath into outputPath (one week byte per record) with the
+// dispatched epoch batch kernels, and spot-checks every FILE_SAMPLE_STRIDE-th
+// in-range record against the scalar conversion.
+FileConversionReport convertColumnFile(const std::string& inputPath, const std::string& outputPath,
+                                       BenchmarkConfig::FileFormat format, size_t threads)
+{
+    FileConversionReport report;
+#ifdef __linux__
+    if constexpr (std::endian::native != std::endian::little) {
+        report.error = "column files are little-endian; this host is not";
+        return report;
+    }
+    MappedFile input;
+    if (report.error = input.openRead(inputPath); !report.error.empty()) {
+        return report;
+    }
+    const size_t recordBytes = fileRecordBytes(format);
+    if (input.size() % recordBytes != 0) {
+        report.error = inputPath + ": size " + std::to_string(input.size()) + " is not a multiple of "
+                       + std::to_string(recordBytes) + " (" + fileFormatName(format) + " records)";
+        return report;
+    }
+    report.records = input.size() / recordBytes;
+    report.inputBytes = input.size();
+    report.outputBytes = report.records;
+    report.threads = fileChunkWorkers(report.records, threads);
+
+    MappedFile output;
+    if (report.error = output.create(outputPath, report.records); !report.error.empty()) {
+        return report;
+    }
+    input.advise(MADV_SEQUENTIAL);
+
+    std::atomic<size_t> mismatches{0};
+    std::atomic<size_t> sampled{0};
+    std::atomic<size_t> outOfRange{0};
+    const auto start = std::chrono::steady_clock::now();
+    forEachFileChunk(report.records, threads, [&](size_t begin, size_t end, size_t) {
+        const size_t count = end - begin;
+        const std::span<uint8_t> weeks(reinterpret_cast<uint8_t*>(output.data()) + begin, count);
+        auto convertChunk = [&](auto records, auto scalar) {
+            size_t rejected = 0;
+            for (size_t offset = 0; offset < count; offset += FILE_VALIDATE_RECORDS) {
+                const size_t n = std::min(FILE_VALIDATE_RECORDS, count - offset);
+                rejected += convertCheckedEpochBlock(records.subspan(offset, n), weeks.subspan(offset, n));
+            }
+            size_t bad = 0;
+            size_t checked = 0;
+            for (size_t i = (FILE_SAMPLE_STRIDE - begin % FILE_SAMPLE_STRIDE) % FILE_SAMPLE_STRIDE; i < count; i += FILE_SAMPLE_STRIDE) {
+                if (epochInputInRange(records[i])) {
+                    ++checked;
+                    bad += weeks[i] != scalar(records[i]);
+                }
+            }
+            mismatches.fetch_add(bad, std::memory_order_relaxed);
+            sampled.fetch_add(checked, std::memory_order_relaxed);
+            outOfRange.fetch_add(rejected, std::memory_order_relaxed);
+        };
+        if (format == BenchmarkConfig::FileFormat::EpochSeconds) {
+            convertChunk(std::span<const int64_t>(reinterpret_cast<const int64_t*>(input.data()) + begin, count),
+                         [](int64_t seconds) { return convertEpochSecondsToWeek(seconds); });
+        } else {
+            convertChunk(std::span<const int32_t>(reinterpret_cast<const int32_t*>(input.data()) + begin, count),
+                         [](int32_t days) { return convertEpochDaysToWeek(days); });
+        }
+    });
+    const auto converted = std::chrono::steady_clock::now();
+    report.error = output.sync(outputPath);
+    const auto flushed = std::chrono::steady_clock::now();
+
+    report.sampled = sampled.load();
+    report.mismatches = mismatches.load();
+    report.outOfRange = outOfRange.load();
+    report.convertSeconds = std::chrono::duration<double>(converted - start).count();
+    report.flushSeconds = std::chrono::duration<double>(flushed - converted).count();
+#else
+    (void)inputPath; (void)outputPath; (void)format; (void)threads;
+    report.error = "column files need mmap (Linux only)";
+#endif
+    return report;
+}
+
+void printFileConversionReport(const FileConversionReport& report, BenchmarkConfig::FileFormat format)
+{
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Records: " << report.records << " (" << fileFormatName(format) << ", "
+              << report.inputBytes / 1e6 << " MB in, " << report.outputBytes / 1e6 << " MB out)" << std::endl;
+    std::cout << "  Threads: " << report.threads << std::endl;
+    std::cout << "  Convert: " << report.convertSeconds * 1e3 << " ms, " << std::setprecision(3)
+              << report.gbPerSecond() << " GB/s (input + output bytes), " << std::setprecision(2)
+              << (report.convertSeconds > 0.0 ? report.records / report.convertSeconds / 1e6 : 0.0) << " M records/s"
+              << std::endl;
+    std::cout << "  Flush (msync): " << report.flushSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "  Spot check: " << report.sampled << " records, " << report.mismatches << " mismatches" << std::endl;
+    std::cout << "  Out of range (not 0001-01-01 .. 9999-12-31, written as week 0): " << report.outOfRange
+              << " records" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+// ============================================================================
+// EXHAUSTIVE VERIFICATION
+// ============================================================================
+// Checks every (year, yday) of a year range, for every variant, against a
+// reference that shares no code with the kernels: the Jan 1 weekday is carried
+// forward year by year from 0001-01-01 (a Monday) and the ISO week is read off
+// the Thursday of the date's week. The reference is itself cross-checked with
+// strftime("%G %V %u"). Years are limited to the int16_t batch columns.
+
+constexpr int VERIFY_MIN_YEAR = 1;
+constexpr int VERIFY_MAX_YEAR = 32767;
+constexpr int VERIFY_YEAR_BLOCK = 64;
+
+inline IsoWeekDate referenceIsoWeekDate(int year, int yday, int jan1Weekday) noexcept
+{
+    const int weekday = (jan1Weekday - 1 + yday) % 7 + 1;        // 1 = Monday
+    int thursday = yday - weekday + 4;                            // yday of that week's Thursday
+    int isoYear = year;
+    if (thursday < 0) {
+        isoYear = year - 1;
+        thursday += daysInYear(year - 1);
+    } else if (thursday >= daysInYear(year)) {
+        isoYear = year + 1;
+        thursday -= daysInYear(year);
+    }
+    return makeIsoWeekDate(isoYear, thursday / 7 + 1, weekday);
+}
+
+// Parameter types of a kernel, for adapters that take the kernel as a
+// template argument.
+template<typename F> struct FunctionArgs;
+template<typename R, typename... Args>
+struct FunctionArgs<R (*)(Args...) noexcept> { using type = std::tuple<Args...>; };
+template<typename R, typename... Args>
+struct FunctionArgs<R (*)(Args...)> { using type = std::tuple<Args...>; };
+
+// Inputs for one block of years in every form the variants take, plus the
+// reference results and scratch outputs.
+struct VerifyBlock {
+    std::vector<int16_t> years;
+    std::vector<int16_t> ydays;
+    std::vector<struct tm> timeStructs;
+    std::vector<int32_t> epochDays;
+    std::vector<int64_t> epochSeconds;
+    std::vector<IsoWeekDate> expected;
+    std::vector<uint8_t> weeks;
+    std::vector<uint32_t> packed;
+
+    size_t size() const noexcept { return years.size(); }
+};
+
+struct VerifyVariant {
+    const char* name;
+    bool fullResult;                                              // false: only .week is produced
+    void (*run)(VerifyBlock& block, std::span<IsoWeekDate> out);
+};
+
+template<auto Func>
+void verifyPerCall(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    for (size_t i = 0; i < block.size(); ++i) {
+        const auto r = Func(block.timeStructs[i]);
+        if constexpr (std::is_same_v<decltype(r), const IsoWeekDate>) {
+            out[i] = r;
+        } else {
+            out[i].week = static_cast<uint8_t>(r);
+        }
+    }
+}
+
+// Batch kernels over the year/yday columns: week-only, full or packed output.
+template<auto Kernel>
+void verifyBatch(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    using OutSpan = std::tuple_element_t<2, typename FunctionArgs<decltype(Kernel)>::type>;
+    using OutT = typename OutSpan::element_type;
+    if constexpr (std::is_same_v<OutT, IsoWeekDate>) {
+        Kernel(block.years, block.ydays, out);
+    } else if constexpr (std::is_same_v<OutT, uint32_t>) {
+        Kernel(block.years, block.ydays, block.packed);
+        for (size_t i = 0; i < block.size(); ++i) {
+            out[i] = unpackIsoWeekDate(block.packed[i]);
+        }
+    } else {
+        Kernel(block.years, block.ydays, block.weeks);
+        for (size_t i = 0; i < block.size(); ++i) {
+            out[i].week = block.weeks[i];
+        }
+    }
+}
+
+// Per-call epoch kernels, fed epoch days or the last second of each day.
+template<auto Func, bool Seconds>
+void verifyEpochPerCall(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    for (size_t i = 0; i < block.size(); ++i) {
+        const auto r = Func(Seconds ? block.epochSeconds[i] : int64_t(block.epochDays[i]));
+        if constexpr (std::is_same_v<decltype(r), const IsoWeekDate>) {
+            out[i] = r;
+        } else {
+            out[i].week = static_cast<uint8_t>(r);
+        }
+    }
+}
+
+template<auto Kernel>
+void verifyEpochBatch(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    using InSpan = std::tuple_element_t<0, typename FunctionArgs<decltype(Kernel)>::type>;
+    if constexpr (std::is_same_v<typename InSpan::element_type, const int64_t>) {
+        Kernel(block.epochSeconds, block.weeks);
+    } else {
+        Kernel(block.epochDays, block.weeks);
+    }
+    for (size_t i = 0; i < block.size(); ++i) {
+        out[i].week = block.weeks[i];
+    }
+}
+
+// Text kernels on the block formatted as "YYYY-MM-DD" lines. Years above 9999
+// have no four-digit form and are passed through from the reference.
+template<auto Kernel>
+void verifyText(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    std::string text(block.size() * ISO_DATE_LINE_BYTES, '\n');
+    for (size_t i = 0; i < block.size(); ++i) {
+        if (block.years[i] <= 9999) {
+            formatIsoDateLine(block.years[i], block.ydays[i], text.data() + i * ISO_DATE_LINE_BYTES);
+        }
+    }
+    Kernel(text, block.weeks, true);
+    for (size_t i = 0; i < block.size(); ++i) {
+        out[i].week = block.years[i] <= 9999 ? block.weeks[i] : block.expected[i].week;
+    }
+}
+
+// Reverse kernels get the reference ISO week date of each day, and the date
+// they return goes back through Original, so a correct inverse reproduces the
+// reference.
+inline IsoWeekDate originalIsoWeekDateOf(YearDay d)
+{
+    return convertGregorianDateToIsoWeekDate_Original(timeStructFor(static_cast<int>(d.year), d.yday));
+}
+
+template<auto Func>
+void verifyReverse(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    for (size_t i = 0; i < block.size(); ++i) {
+        const auto r = Func(block.expected[i]);
+        if constexpr (std::is_same_v<decltype(r), const YearDay>) {
+            out[i] = originalIsoWeekDateOf(r);
+        } else {
+            out[i] = originalIsoWeekDateOf(civilYearDayFromDays(r));
+        }
+    }
+}
+
+template<auto Kernel>
+void verifyReverseBatch(VerifyBlock& block, std::span<IsoWeekDate> out)
+{
+    std::vector<uint32_t> packed(block.size());
+    for (size_t i = 0; i < block.size(); ++i) {
+        packed[i] = packIsoWeekDate(block.expected[i]);
+    }
+    if constexpr (std::tuple_size_v<typename FunctionArgs<decltype(Kernel)>::type> == 3) {
+        std::vector<int16_t> years(block.size());
+        std::vector<int16_t> ydays(block.size());
+        Kernel(packed, years, ydays);
+        for (size_t i = 0; i < block.size(); ++i) {
+            out[i] = originalIsoWeekDateOf({years[i], ydays[i]});
+        }
+    } else {
+        std::vector<int32_t> days(block.size());
+        Kernel(packed, days);
+        for (size_t i = 0; i < block.size(); ++i) {
+            out[i] = originalIsoWeekDateOf(civilYearDayFromDays(days[i]));
+        }
+    }
+}
+
+struct VerifyMismatch {
+    int year;
+    int yday;
+    IsoWeekDate expected;
+    IsoWeekDate actual;
+
+    bool operator<(const VerifyMismatch& o) const noexcept {
+        return year != o.year ? year < o.year : yday < o.yday;
+    }
+};
+
+struct VerifyVariantResult {
+    size_t mismatches = 0;
+    double totalNs = 0.0;                                         // summed over threads
+    std::vector<VerifyMismatch> first;                            // earliest dates, at most VERIFY_REPORTED
+};
+
+struct VerifyReport {
+    int minYear = 0;
+    int maxYear = 0;
+    size_t pairs = 0;
+    size_t threads = 0;
+    double wallNs = 0.0;
+    std::vector<VerifyVariant> variants;
+    std::vector<VerifyVariantResult> results;
+    VerifyVariantResult reference;                                // reference vs strftime
+
+    bool passed() const noexcept {
+        if (reference.mismatches) return false;
+        for (const auto& r : results) {
+            if (r.mismatches) return false;
+        }
+        return true;
+    }
+};
+
+constexpr size_t VERIFY_REPORTED = 5;
+
+inline void recordMismatch(VerifyVariantResult& r, const VerifyMismatch& m)
+{
+    if (r.mismatches++ < VERIFY_REPORTED) {
+        r.first.push_back(m);
+    }
+}
+
+// Each thread takes blocks of VERIFY_YEAR_BLOCK years in increasing order,
+// so the first VERIFY_REPORTED mismatches of every thread include the
+// earliest ones overall.
+inline VerifyReport verifyExhaustive(int minYear, int maxYear, size_t threads, std::vector<VerifyVariant> variants)
+{
+    VerifyReport report;
+    report.minYear = minYear;
+    report.maxYear = maxYear;
+    report.variants = std::move(variants);
+
+    std::vector<uint8_t> jan1Weekday(static_cast<size_t>(maxYear) + 1);
+    jan1Weekday[1] = 1;
+    for (int y = 1; y < maxYear; ++y) {
+        jan1Weekday[y + 1] = static_cast<uint8_t>((jan1Weekday[y] - 1 + daysInYear(y)) % 7 + 1);
+    }
+    for (int y = minYear; y <= maxYear; ++y) {
+        report.pairs += daysInYear(y);
+    }
+
+    const size_t blocks = static_cast<size_t>(maxYear - minYear) / VERIFY_YEAR_BLOCK + 1;
+    report.threads = std::clamp<size_t>(threads, 1, blocks);
+
+    std::vector<std::vector<VerifyVariantResult>> perThread(report.threads,
+        std::vector<VerifyVariantResult>(report.variants.size()));
+    std::vector<VerifyVariantResult> perThreadReference(report.threads);
+    std::atomic<size_t> nextBlock{0};
+
+    auto worker = [&](size_t t) {
+        auto& results = perThread[t];
+        auto& reference = perThreadReference[t];
+        VerifyBlock block;
+        std::vector<IsoWeekDate> out;
+        char text[32];
+        for (size_t b; (b = nextBlock.fetch_add(1, std::memory_order_relaxed)) < blocks; ) {
+            const int first = minYear + static_cast<int>(b) * VERIFY_YEAR_BLOCK;
+            const int last = std::min(maxYear, first + VERIFY_YEAR_BLOCK - 1);
+            block.years.clear();
+            block.ydays.clear();
+            block.timeStructs.clear();
+            block.epochDays.clear();
+            block.epochSeconds.clear();
+            block.expected.clear();
+            for (int y = first; y <= last; ++y) {
+                const int64_t jan1 = daysFromYearDay(y, 0);
+                for (int d = 0; d < daysInYear(y); ++d) {
+                    const IsoWeekDate expected = referenceIsoWeekDate(y, d, jan1Weekday[y]);
+                    struct tm times;
+                    std::memset(&times, 0, sizeof(times));
+                    times.tm_year = y - 1900;
+                    times.tm_yday = d;
+                    times.tm_mday = 1;                            // Keeps MSVC's parameter validation happy
+                    times.tm_wday = expected.weekday % 7;         // 0 = Sunday
+
+                    int isoYear = 0, week = 0, weekday = 0;
+                    if (std::strftime(text, sizeof(text), "%G %V %u", &times) == 0
+                        || std::sscanf(text, "%d %d %d", &isoYear, &week, &weekday) != 3
+                        || !(makeIsoWeekDate(isoYear, week, weekday) == expected)) {
+                        recordMismatch(reference, {y, d, expected, makeIsoWeekDate(isoYear, week, weekday)});
+                    }
+
+                    times.tm_mday = 0;
+                    times.tm_wday = 0;
+                    block.years.push_back(static_cast<int16_t>(y));
+                    block.ydays.push_back(static_cast<int16_t>(d));
+                    block.timeStructs.push_back(times);
+                    block.epochDays.push_back(static_cast<int32_t>(jan1 + d));
+                    block.epochSeconds.push_back((jan1 + d) * 86400 + 86399);
+                    block.expected.push_back(expected);
+                }
+            }
+            block.weeks.resize(block.size());
+            block.packed.resize(block.size());
+            out.resize(block.size());
+
+            for (size_t v = 0; v < report.variants.size(); ++v) {
+                const VerifyVariant& variant = report.variants[v];
+                std::fill(out.begin(), out.end(), IsoWeekDate{});
+                const auto start = std::chrono::steady_clock::now();
+                variant.run(block, out);
+                results[v].totalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                for (size_t i = 0; i < block.size(); ++i) {
+                    const IsoWeekDate& e = block.expected[i];
+                    const bool ok = variant.fullResult ? out[i] == e : out[i].week == e.week;
+                    if (!ok) {
+                        recordMismatch(results[v], {block.years[i], block.ydays[i], e, out[i]});
+                    }
+                }
+            }
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> pool;
+        for (size_t t = 1; t < report.threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    report.wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    auto merge = [](VerifyVariantResult& into, const VerifyVariantResult& from) {
+        into.mismatches += from.mismatches;
+        into.totalNs += from.totalNs;
+        into.first.insert(into.first.end(), from.first.begin(), from.first.end());
+    };
+    auto trim = [](VerifyVariantResult& r) {
+        std::sort(r.first.begin(), r.first.end());
+        if (r.first.size() > VERIFY_REPORTED) r.first.resize(VERIFY_REPORTED);
+    };
+    report.results.resize(report.variants.size());
+    for (size_t t = 0; t < report.threads; ++t) {
+        for (size_t v = 0; v < report.variants.size(); ++v) {
+            merge(report.results[v], perThread[t][v]);
+        }
+        merge(report.reference, perThreadReference[t]);
+    }
+    for (auto& r : report.results) trim(r);
+    trim(report.reference);
+    return report;
+}
+
+inline std::string formatIsoWeekDate(IsoWeekDate d, bool fullResult)
+{
+    char text[32];
+    if (fullResult) {
+        std::snprintf(text, sizeof(text), "%d-W%02d-%d", d.isoYear, d.week, d.weekday);
+    } else {
+        std::snprintf(text, sizeof(text), "W%02d", d.week);
+    }
+    return text;
+}
+
+void printVerifyReport(const VerifyReport& report)
+{
+    const size_t checks = report.pairs * report.variants.size();
+    std::cout << "=== Exhaustive verification: years " << report.minYear << "-" << report.maxYear << " ===" << std::endl;
+    std::cout << "  " << report.pairs << " (year, yday) pairs x " << report.variants.size() << " variants, "
+              << report.threads << " thread(s)" << std::endl << std::endl;
+
+    auto printMismatches = [](const VerifyVariantResult& r, bool fullResult) {
+        for (const auto& m : r.first) {
+            std::cout << "      " << m.year << " yday " << m.yday
+                      << ": expected " << formatIsoWeekDate(m.expected, fullResult)
+                      << ", got " << formatIsoWeekDate(m.actual, fullResult) << std::endl;
+        }
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(26) << "Reference vs strftime"
+              << (report.reference.mismatches ? "FAIL" : "PASS") << "  " << report.reference.mismatches << " mismatches" << std::endl;
+    printMismatches(report.reference, true);
+    for (size_t v = 0; v < report.variants.size(); ++v) {
+        const VerifyVariantResult& r = report.results[v];
+        std::cout << "  " << std::setw(26) << report.variants[v].name
+                  << (r.mismatches ? "FAIL" : "PASS") << "  " << std::right << std::setw(8) << r.mismatches
+                  << " mismatches  " << std::setw(8) << r.totalNs / report.pairs << " ns/pair"
+                  << (report.variants[v].fullResult ? "" : "  (week only)") << std::left << std::endl;
+        printMismatches(r, report.variants[v].fullResult);
+    }
+    std::cout << std::right << std::endl;
+    std::cout << "  " << checks << " checks in " << report.wallNs / 1e6 << " ms ("
+              << checks / (report.wallNs / 1e9) / 1e6 << " M checks/s, including reference and strftime)" << std::endl;
+    std::cout << "  Result: " << (report.passed() ? "PASS" : "FAIL") << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+// ============================================================================
+// TEST DATA STRUCTURES
+// ============================================================================
+
+// Allocator that leaves trivially constructible elements uninitialised on
+// resize, so the pages of a large column are first touched by the generator
+// thread that fills them instead of a serial zeroing pass.
+template<typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template<typename U> struct rebind { using other = DefaultInitAllocator<U>; };
+    DefaultInitAllocator() = default;
+    template<typename U> DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+    template<typename U> void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template<typename U, typename... Args> void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template<typename T>
+using CorpusColumn = std::vector<T, DefaultInitAllocator<T>>;
+
+// Structure-of-arrays test corpus. The year/yday columns (4 bytes per case)
+// feed the batch and epoch kernels and the reference checks; the struct tm
+// column is only there for the per-call kernels that take const tm& and can
+// be released once they have run. Only the edge cases appended after the
+// random block carry a description.
+struct TestCorpus {
+    CorpusColumn<int16_t> years;
+    CorpusColumn<int16_t> ydays;                 // Zero-based day of year
+    CorpusColumn<struct tm> timeStructs;         // Empty after releaseTimeStructs()
+    size_t edgeCaseBegin = 0;
+    std::vector<std::string> edgeDescriptions;
+
+    size_t size() const noexcept { return years.size(); }
+    int year(size_t i) const noexcept { return years[i]; }
+    int dayOfYear(size_t i) const noexcept { return ydays[i] + 1; }
+
+    // Built from the compact columns, so it stays valid after releaseTimeStructs().
+    struct tm timeStruct(size_t i) const noexcept {
+        struct tm t;
+        std::memset(&t, 0, sizeof(t));
+        t.tm_year = years[i] - 1900;
+        t.tm_yday = ydays[i];
+        return t;
+    }
+
+    std::string_view description(size_t i) const noexcept {
+        return i >= edgeCaseBegin ? std::string_view(edgeDescriptions[i - edgeCaseBegin]) : "Random";
+    }
+
+    size_t memoryBytes() const noexcept {
+        size_t bytes = years.capacity() * sizeof(int16_t) + ydays.capacity() * sizeof(int16_t)
+                     + timeStructs.capacity() * sizeof(struct tm);
+        for (const auto& d : edgeDescriptions) {
+            bytes += sizeof(std::string) + d.capacity();
+        }
+        return bytes;
+    }
+
+    void releaseTimeStructs() { CorpusColumn<struct tm>().swap(timeStructs); }
+};
+
+// ============================================================================
+// TEST DATA GENERATOR
+// ============================================================================
+
+// The random block is cut into fixed-size blocks, each with its own mt19937
+// seeded from (seed, block index). Threads pull blocks from a shared counter,
+// so the corpus is identical for any generator thread count.
+constexpr size_t GENERATOR_BLOCK = 1 << 16;
+constexpr uint32_t GENERATOR_SEED = 42;
+
+constexpr int RECENT_WINDOW_DAYS = 730;
+
+// Day-number span the Sorted and Recent distributions draw from.
+struct GeneratorSpan {
+    int64_t firstDay;
+    int64_t dayCount;
+};
+
+inline GeneratorSpan generatorSpan(const BenchmarkConfig& config) {
+    const int64_t first = daysFromYearDay(config.minYear, 0);
+    const int64_t last = daysFromYearDay(config.maxYear + 1, 0) - 1;
+    if (config.distribution != BenchmarkConfig::Distribution::Recent) {
+        return {first, last - first + 1};
+    }
+    const int64_t today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now()).time_since_epoch().count();
+    const int64_t end = std::clamp(today, first, last);
+    const int64_t begin = std::max(first, end - RECENT_WINDOW_DAYS + 1);
+    return {begin, end - begin + 1};
+}
+
+inline void generateRandomBlock(TestCorpus& corpus, size_t block, size_t begin, size_t end,
+                                const BenchmarkConfig& config, GeneratorSpan span) {
+    using Distribution = BenchmarkConfig::Distribution;
+    std::seed_seq seq{GENERATOR_SEED, static_cast<uint32_t>(block), static_cast<uint32_t>(uint64_t(block) >> 32)};
+    std::mt19937 gen(seq);
+    std::uniform_int_distribution<> year_dist(config.minYear, config.maxYear);
+    std::uniform_int_distribution<> day_dist(1, 365);
+    std::uniform_int_distribution<int64_t> span_dist(0, span.dayCount - 1);
+    std::uniform_int_distribution<> boundary_dist(0, 13);
+    std::uniform_int_distribution<> mid_dist(8, 357);
+    std::bernoulli_distribution coin;
+
+    for (size_t i = begin; i < end; ++i) {
+        int year;
+        int dayOfYear;
+        switch (config.distribution) {
+        case Distribution::Sorted:
+        case Distribution::Recent: {
+            const int64_t offset = config.distribution == Distribution::Sorted
+                ? static_cast<int64_t>(i % static_cast<uint64_t>(span.dayCount)) : span_dist(gen);
+            const YearDay yd = civilYearDayFromDays(span.firstDay + offset);
+            year = static_cast<int>(yd.year);
+            dayOfYear = yd.yday + 1;
+            break;
+        }
+        case Distribution::Boundary: {
+            year = year_dist(gen);
+            const int slot = boundary_dist(gen);
+            dayOfYear = slot < 7 ? slot + 1 : daysInYear(year) - (13 - slot);   // First or last 7 days
+            break;
+        }
+        case Distribution::Alternating:
+            if (i & 1) {
+                // Mid-year: never part of another ISO year.
+                year = year_dist(gen);
+                dayOfYear = mid_dist(gen);
+            } else {
+                // Jan 1-3 in the previous ISO year or Dec 29-31 in the next one;
+                // retries are bounded for ranges too narrow to contain either.
+                const bool previous = coin(gen);
+                for (int attempt = 0; ; ++attempt) {
+                    year = year_dist(gen);
+                    dayOfYear = previous ? 1 + static_cast<int>(gen() % 3) : daysInYear(year) - static_cast<int>(gen() % 3);
+                    const int isoYear = isoWeekDate_V4(year, dayOfYear).isoYear;
+                    if ((previous ? isoYear < year : isoYear > year) || attempt == 64) {
+                        break;
+                    }
+                }
+            }
+            break;
+        default:
+            year = year_dist(gen);
+            dayOfYear = day_dist(gen);
+            break;
+        }
+
+        int maxDay = (!(year & 3) && ((year % 100) || !(year % 400))) ? 366 : 365;
+        if (dayOfYear > maxDay) {
+            dayOfYear = maxDay;
+        }
+
+        corpus.years[i] = static_cast<int16_t>(year);
+        corpus.ydays[i] = static_cast<int16_t>(dayOfYear - 1);
+        corpus.timeStructs[i] = corpus.timeStruct(i);
+    }
+}
+
+inline TestCorpus generateTestData(const BenchmarkConfig& config) {
+    TestCorpus corpus;
+
+    struct EdgeCase { int year; int dayOfYear; std::string description; };
+    std::vector<EdgeCase> edgeCases;
+    if (config.includeEdgeCases) {
+        std::vector<int> centuries = {1800, 1900, 2000, 2100, 2200};
+        for (int cent : centuries) {
+            if (cent >= config.minYear && cent <= config.maxYear) {
+                edgeCases.push_back({cent, 1, "Century start: " + std::to_string(cent)});
+            }
+        }
+
+        for (int year = config.minYear; year <= config.maxYear; year += 4) {
+            if ((!(year & 3) && ((year % 100) || !(year % 400)))) {
+                edgeCases.push_back({year, 60, "Leap year Feb 29: " + std::to_string(year)});
+            }
+        }
+    }
+
+    const size_t randomCount = config.testDataSize;
+    const size_t total = randomCount + edgeCases.size();
+    corpus.years.resize(total);
+    corpus.ydays.resize(total);
+    corpus.timeStructs.resize(total);
+    corpus.edgeCaseBegin = randomCount;
+
+    const size_t blocks = (randomCount + GENERATOR_BLOCK - 1) / GENERATOR_BLOCK;
+    size_t threads = config.generatorThreads ? config.generatorThreads : std::thread::hardware_concurrency();
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(1, blocks));
+
+    const GeneratorSpan span = generatorSpan(config);
+    std::atomic<size_t> nextBlock{0};
+    auto worker = [&] {
+        for (size_t b; (b = nextBlock.fetch_add(1, std::memory_order_relaxed)) < blocks; ) {
+            const size_t begin = b * GENERATOR_BLOCK;
+            generateRandomBlock(corpus, b, begin, std::min(begin + GENERATOR_BLOCK, randomCount), config, span);
+        }
+    };
+    {
+        std::vector<std::jthread> pool;
+        for (size_t t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+    }
+
+    corpus.edgeDescriptions.reserve(edgeCases.size());
+    for (size_t k = 0; k < edgeCases.size(); ++k) {
+        const size_t i = randomCount + k;
+        corpus.years[i] = static_cast<int16_t>(edgeCases[k].year);
+        corpus.ydays[i] = static_cast<int16_t>(edgeCases[k].dayOfYear - 1);
+        corpus.timeStructs[i] = corpus.timeStruct(i);
+        corpus.edgeDescriptions.push_back(std::move(edgeCases[k].description));
+    }
+
+    return corpus;
+}
+
+// ============================================================================
+// TAIL-LATENCY ATTRIBUTION
+// ============================================================================
+// With --tail-threshold every sample above the threshold is recorded with
+// its time, and the samples of each thread are cut into windows of
+// tailWindowSamples samples. At every window boundary the thread's own
+// fault and context switch counters (getrusage(RUSAGE_THREAD)) and its CPU
+// (sched_getcpu) are read; the counters are read between samples, so no
+// timed call pays for them. Each outlier is attributed to the strongest
+// kernel event of its window. Outliers in windows without any event are
+// the algorithm's own cost (cache and TLB misses, the slow path of a
+// branch) or an interrupt, which getrusage does not count.
+enum class TailCause { MajorFault, Migration, Preemption, VoluntarySwitch, MinorFault, None };
+constexpr size_t TAIL_CAUSES = 6;
+
+// Windows are shrunk below tailWindowSamples so that a run of few samples
+// (batch kernels time whole chunks) still gets this many windows per thread.
+constexpr size_t TAIL_MIN_WINDOWS = 64;
+
+inline const char* tailCauseName(TailCause cause) {
+    switch (cause) {
+    case TailCause::MajorFault: return "major-fault";
+    case TailCause::Migration: return "migration";
+    case TailCause::Preemption: return "preempted";
+    case TailCause::VoluntarySwitch: return "voluntary-switch";
+    case TailCause::MinorFault: return "minor-fault";
+    default: return "none";
+    }
+}
+
+// Kernel activity counters of the calling thread.
+struct ThreadActivity {
+    long minorFaults = 0;
+    long majorFaults = 0;
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+    int cpu = -1;
+
+    static ThreadActivity capture() {
+        ThreadActivity activity;
+#ifdef __linux__
+        struct rusage usage;
+        if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+            activity.minorFaults = usage.ru_minflt;
+            activity.majorFaults = usage.ru_majflt;
+            activity.voluntarySwitches = usage.ru_nvcsw;
+            activity.involuntarySwitches = usage.ru_nivcsw;
+        }
+        activity.cpu = sched_getcpu();
+#endif
+        return activity;
+    }
+};
+
+// A major fault stalls for I/O, a migration starts over with cold caches,
+// and a preemption loses the CPU for a time slice; those outrank the cheap
+// minor fault when a window saw several events.
+inline TailCause classifyTailWindow(const ThreadActivity& before, const ThreadActivity& after) {
+    if (after.majorFaults > before.majorFaults) {
+        return TailCause::MajorFault;
+    }
+    if (after.cpu != before.cpu) {
+        return TailCause::Migration;
+    }
+    if (after.involuntarySwitches > before.involuntarySwitches) {
+        return TailCause::Preemption;
+    }
+    if (after.voluntarySwitches > before.voluntarySwitches) {
+        return TailCause::VoluntarySwitch;
+    }
+    if (after.minorFaults > before.minorFaults) {
+        return TailCause::MinorFault;
+    }
+    return TailCause::None;
+}
+
+struct TailEvent {
+    size_t trial = 1;                   // --trials: 1-based trial of the variant
+    double timeMs = 0.0;                // Since the start of the run (of the trial)
+    double sampleNs = 0.0;
+    long thread = 0;                    // Kernel thread id (0: unknown)
+    size_t window = 0;                  // Window index within the thread
+    int cpuBefore = -1;                 // CPU at the window start and end
+    int cpuAfter = -1;
+    long minorFaults = 0;               // Counter deltas over the window
+    long majorFaults = 0;
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+    TailCause cause = TailCause::None;
+};
+
+// Outliers of one run. windowsByCause counts all windows, with or without
+// outliers, so a cause can be compared with how often it happens anyway.
+struct TailReport {
+    double thresholdNs = 0.0;
+    size_t samples = 0;
+    size_t windows = 0;
+    std::array<size_t, TAIL_CAUSES> outliersByCause{};
+    std::array<size_t, TAIL_CAUSES> windowsByCause{};
+    std::vector<TailEvent> events;
+
+    bool enabled() const { return thresholdNs > 0.0; }
+
+    void merge(TailReport&& other) {
+        samples += other.samples;
+        windows += other.windows;
+        for (size_t c = 0; c < TAIL_CAUSES; ++c) {
+            outliersByCause[c] += other.outliersByCause[c];
+            windowsByCause[c] += other.windowsByCause[c];
+        }
+        events.insert(events.end(), std::make_move_iterator(other.events.begin()),
+                      std::make_move_iterator(other.events.end()));
+    }
+};
+
+// Per-thread recorder fed by the timed loop: sample() after every sample.
+class TailRecorder {
+public:
+    TailRecorder(double thresholdNs, size_t samplesPerWindow, std::chrono::steady_clock::time_point timeOrigin)
+        : windowSamples(std::max<size_t>(1, samplesPerWindow)), origin(timeOrigin) {
+        report.thresholdNs = thresholdNs;
+        // A window holds at most windowSamples outliers; fault their storage
+        // in now so that recording one does not fault inside a window.
+        pending.resize(windowSamples);
+        pending.clear();
+        windowStart = ThreadActivity::capture();
+#ifdef __linux__
+        thread = static_cast<long>(syscall(SYS_gettid));
+#endif
+    }
+
+    void sample(double ns) {
+        if (ns > report.thresholdNs) [[unlikely]] {
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+            pending.push_back({ms, ns});
+        }
+        if (++inWindow == windowSamples) [[unlikely]] {
+            closeWindow();
+        }
+    }
+
+    TailReport finish() {
+        if (inWindow) {
+            closeWindow();
+        }
+        return std::move(report);
+    }
+
+private:
+    void closeWindow() {
+        const ThreadActivity end = ThreadActivity::capture();
+        const TailCause cause = classifyTailWindow(windowStart, end);
+        for (const auto& [ms, ns] : pending) {
+            TailEvent event;
+            event.timeMs = ms;
+            event.sampleNs = ns;
+            event.thread = thread;
+            event.window = report.windows;
+            event.cpuBefore = windowStart.cpu;
+            event.cpuAfter = end.cpu;
+            event.minorFaults = end.minorFaults - windowStart.minorFaults;
+            event.majorFaults = end.majorFaults - windowStart.majorFaults;
+            event.voluntarySwitches = end.voluntarySwitches - windowStart.voluntarySwitches;
+            event.involuntarySwitches = end.involuntarySwitches - windowStart.involuntarySwitches;
+            event.cause = cause;
+            report.events.push_back(event);
+            ++report.outliersByCause[static_cast<size_t>(cause)];
+        }
+        ++report.windowsByCause[static_cast<size_t>(cause)];
+        ++report.windows;
+        report.samples += inWindow;
+        // Growing the event list can fault; start the next window after it.
+        windowStart = pending.empty() ? end : ThreadActivity::capture();
+        pending.clear();
+        inWindow = 0;
+    }
+
+    size_t windowSamples;
+    std::chrono::steady_clock::time_point origin;
+    ThreadActivity windowStart;
+    long thread = 0;
+    size_t inWindow = 0;
+    std::vector<std::pair<double, double>> pending;   // (ms, ns) of this window's outliers
+    TailReport report;
+};
+
+// Collects the recorders of all workers of one run. Until enable() is
+// called (and without --tail-threshold) run() passes no recorder, so the
+// timed loops stay as they are.
+class TailCollector {
+public:
+    void enable(const BenchmarkConfig& config) {
+        thresholdNs = config.tailThresholdNs;
+        windowSamples = config.tailWindowSamples;
+        origin = std::chrono::steady_clock::now();
+        report.thresholdNs = thresholdNs;
+    }
+
+    // timedLoop(TailRecorder*) executes the timed loop of one worker, which
+    // takes about sampleCount samples. The samples it stores must not add
+    // minor faults of their own to the windows, so their storage is faulted
+    // in first.
+    template<typename Stats, typename Run>
+    size_t run(Stats& stats, size_t sampleCount, Run timedLoop) {
+        if (thresholdNs <= 0.0) {
+            return timedLoop(static_cast<TailRecorder*>(nullptr));
+        }
+        stats.prefault();
+        const size_t window = std::clamp<size_t>(sampleCount / TAIL_MIN_WINDOWS, 1, windowSamples);
+        TailRecorder recorder(thresholdNs, window, origin);
+        const size_t calls = timedLoop(&recorder);
+        TailReport threadReport = recorder.finish();
+        std::lock_guard<std::mutex> lock(mutex);
+        report.merge(std::move(threadReport));
+        return calls;
+    }
+
+    TailReport take() {
+        std::sort(report.events.begin(), report.events.end(),
+                  [](const TailEvent& a, const TailEvent& b) { return a.timeMs < b.timeMs; });
+        return std::move(report);
+    }
+
+private:
+    double thresholdNs = 0.0;
+    size_t windowSamples = 1;
+    std::chrono::steady_clock::time_point origin;
+    std::mutex mutex;
+    TailReport report;
+};
+
+// ============================================================================
+// BENCHMARK RESULT STRUCTURE
+// ============================================================================
+struct ThreadRunStats {
+    int cpu = -1;                       // CPU the worker was pinned to (-1: not pinned)
+    size_t calls = 0;
+    double wallNs = 0.0;                // Wall time of the timed loop
+    double throughputDatesPerSec = 0.0; // 1e9 / mean sample time
+};
+
+struct ConfidenceInterval {
+    double low = 0.0;
+    double high = 0.0;
+};
+
+// How a result was combined from independent trials (see combineTrials).
+struct TrialSummary {
+    size_t count = 1;
+    size_t rejected = 0;                // Trials dropped as outliers
+    ConfidenceInterval median;          // Bootstrap intervals over the kept trials
+    ConfidenceInterval mean;
+    double minMHz = 0.0;                // Clock range seen at trial starts (0: unknown)
+    double maxMHz = 0.0;
+};
+
+struct BenchmarkResult {
+    std::string versionName;
+    double averageTimeNs;
+    double minTimeNs;
+    double maxTimeNs;
+    double medianTimeNs;
+    double percentile95Ns;
+    double percentile99Ns;
+    size_t iterations;
+    double throughputDatesPerSec;
+    std::string timingMode = "chunk";
+    std::string statsBackend;
+    size_t threadCount = 1;
+    double scalingEfficiency = 1.0;
+    std::vector<ThreadRunStats> threadStats;
+    double timerOverheadNs = 0.0;
+    bool correctnessCheck;
+    size_t discrepancies;
+    PerfCounts perf;                    // Hardware counters over the timed run (may be empty)
+    size_t inputBytesPerConversion = 0; // Text variants: bytes parsed per date (for MB/s)
+    size_t codeBytes = 0;               // Machine code of the variant's entry point (0: unknown)
+    TrialSummary trials;
+    TailReport tail;                    // Outliers of the run (--tail-threshold)
+
+    // Memory stats
+    MemoryStats memoryBefore;
+    MemoryStats memoryAfter;
+    size_t functionStackBytes;
+};
+
+// ============================================================================
+// RESULT HELPERS (week-only and full-result kernels share the harness)
+// ============================================================================
+// Reduces a kernel result to a scalar that can be stored into a volatile.
+inline int benchmarkSink(int week) noexcept { return week; }
+inline uint32_t benchmarkSink(IsoWeekDate d) noexcept { return packIsoWeekDate(d); }
+inline int64_t benchmarkSink(int64_t days) noexcept { return days; }
+inline int64_t benchmarkSink(YearDay d) noexcept { return d.year * 512 + d.yday; }
+
+inline int weekOf(int week) noexcept { return week; }
+inline int weekOf(IsoWeekDate d) noexcept { return d.week; }
+inline int weekOf(uint32_t packed) noexcept { return unpackIsoWeekDate(packed).week; }
+// Reverse kernels report the week of the date they produced.
+inline int weekOf(int64_t days) noexcept { return convertEpochDaysToWeek(days); }
+inline int weekOf(YearDay d) noexcept
+{
+    return convertGregorianDateToWeekDate_Original(timeStructFor(static_cast<int>(d.year), d.yday));
+}
+
+// Week numbers are checked against Original, full results against Original's full result.
+inline bool matchesReference(const struct tm& times, int week) noexcept
+{
+    return week == convertGregorianDateToWeekDate_Original(times);
+}
+
+inline bool matchesReference(const struct tm& times, IsoWeekDate d) noexcept
+{
+    return d == convertGregorianDateToIsoWeekDate_Original(times);
+}
+
+inline bool matchesReference(const struct tm& times, uint32_t packed) noexcept
+{
+    return matchesReference(times, unpackIsoWeekDate(packed));
+}
+
+// Reverse kernels are checked against the corpus date itself.
+inline bool matchesReference(const struct tm& times, YearDay d) noexcept
+{
+    return d.year == times.tm_year + 1900 && d.yday == times.tm_yday;
+}
+
+inline bool matchesReference(const struct tm& times, int64_t days) noexcept
+{
+    return days == daysFromYearDay(times.tm_year + 1900, times.tm_yday);
+}
+
+// ============================================================================
+// SAMPLE STATISTICS
+// ============================================================================
+// HDR-style log-linear histogram over non-negative nanosecond samples.
+// Samples are quantized to 1/64 ns. Below 4 ns (256 units) every unit has its
+// own bucket; above that each power of two is split into 128 buckets, and a
+// bucket reports its midpoint. Error bounds for reported quantiles:
+//   value <  4 ns : at most 1/128 ns absolute (quantization)
+//   value >= 4 ns : at most 1/256 (0.39%) relative, plus the 1/128 ns above
+// Values above 2^40 units (~17 s) are clamped into the last bucket. Count,
+// sum (average), min and max are tracked exactly. Memory is fixed at
+// BUCKET_COUNT counters (~35 KB) however many samples are recorded.
+class LogLinearHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_BITS = 40;
+    static constexpr double UNITS_PER_NS = 64.0;
+    static constexpr size_t BUCKET_COUNT = static_cast<size_t>(MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LogLinearHistogram() : buckets_(BUCKET_COUNT, 0) {}
+
+    void add(double ns) {
+        const double clamped = std::max(0.0, ns);
+        uint64_t units = static_cast<uint64_t>(clamped * UNITS_PER_NS + 0.5);
+        units = std::min<uint64_t>(units, (uint64_t{1} << MAX_BITS) - 1);
+        ++buckets_[bucketIndex(units)];
+        ++count_;
+        sum_ += clamped;
+        min_ = std::min(min_, clamped);
+        max_ = std::max(max_, clamped);
+    }
+
+    void merge(const LogLinearHistogram& other) {
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    size_t count() const { return count_; }
+    double sum() const { return sum_; }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // Same rank convention as the exact backend: element floor(count * q)
+    // of the sorted samples.
+    double quantile(double q) const {
+        const uint64_t rank = std::min<uint64_t>(static_cast<uint64_t>(count_ * q), count_ - 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            seen += buckets_[i];
+            if (seen > rank) {
+                return std::clamp(bucketMidpointNs(i), min_, max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    static size_t bucketIndex(uint64_t units) {
+        const int msb = std::bit_width(units) - 1;
+        if (msb <= SUB_BUCKET_BITS) {
+            return static_cast<size_t>(units);
+        }
+        const int shift = msb - SUB_BUCKET_BITS;
+        return static_cast<size_t>(shift + 1) * SUB_BUCKETS + static_cast<size_t>((units >> shift) - SUB_BUCKETS);
+    }
+
+    static double bucketMidpointNs(size_t index) {
+        if (index < 2 * SUB_BUCKETS) {
+            return index / UNITS_PER_NS;
+        }
+        const int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+        const uint64_t lower = (static_cast<uint64_t>(index % SUB_BUCKETS) + SUB_BUCKETS) << shift;
+        const double width = static_cast<double>(uint64_t{1} << shift);
+        return (static_cast<double>(lower) + (width - 1.0) / 2.0) / UNITS_PER_NS;
+    }
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = 0.0;
+};
+
+// Collects timing samples with the configured backend and fills the timing
+// fields of a BenchmarkResult. Per-thread instances are merged with merge().
+class SampleStats {
+public:
+    SampleStats(const BenchmarkConfig& config, size_t expectedSamples)
+        : SampleStats(wantsHistogram(config, expectedSamples), expectedSamples) {}
+
+    SampleStats(bool useHistogram, size_t expectedSamples) : useHistogram_(useHistogram) {
+        if (!useHistogram_) {
+            times_.reserve(expectedSamples);
+        }
+    }
+
+    static bool wantsHistogram(const BenchmarkConfig& config, size_t totalSamples) {
+        using StatsBackend = BenchmarkConfig::StatsBackend;
+        return config.statsBackend == StatsBackend::Histogram ||
+               (config.statsBackend == StatsBackend::Auto && totalSamples > config.autoHistogramSamples);
+    }
+
+    void add(double ns) {
+        if (useHistogram_) {
+            histogram_.add(ns);
+        } else {
+            times_.push_back(ns);
+        }
+        sum_ += ns;
+        ++count_;
+    }
+
+    // Touches the reserved sample storage so that the first write to each
+    // page does not fault inside the timed loop (tail attribution).
+    void prefault() {
+        if (!useHistogram_ && times_.empty()) {
+            times_.resize(times_.capacity());
+            times_.clear();
+        }
+    }
+
+    void merge(SampleStats& other) {
+        if (useHistogram_) {
+            histogram_.merge(other.histogram_);
+        } else {
+            times_.insert(times_.end(), other.times_.begin(), other.times_.end());
+            std::vector<double>().swap(other.times_);
+        }
+        sum_ += other.sum_;
+        count_ += other.count_;
+    }
+
+    double mean() const { return count_ ? sum_ / count_ : 0.0; }
+    size_t count() const { return count_; }
+    const char* backendName() const { return useHistogram_ ? "histogram" : "exact"; }
+
+    template<typename Result>
+    void fill(Result& result) {
+        result.statsBackend = backendName();
+        result.averageTimeNs = mean();
+        if (count_ == 0) {
+            result.minTimeNs = result.maxTimeNs = result.medianTimeNs = 0.0;
+            result.percentile95Ns = result.percentile99Ns = 0.0;
+            result.throughputDatesPerSec = 0.0;
+            return;
+        }
+        if (useHistogram_) {
+            result.minTimeNs = histogram_.min();
+            result.maxTimeNs = histogram_.max();
+            result.medianTimeNs = histogram_.quantile(0.5);
+            result.percentile95Ns = histogram_.quantile(0.95);
+            result.percentile99Ns = histogram_.quantile(0.99);
+        } else {
+            std::sort(times_.begin(), times_.end());
+
+            result.minTimeNs = times_.front();
+            result.maxTimeNs = times_.back();
+            result.medianTimeNs = times_[times_.size() / 2];
+            result.percentile95Ns = times_[static_cast<size_t>(times_.size() * 0.95)];
+            result.percentile99Ns = times_[static_cast<size_t>(times_.size() * 0.99)];
+        }
+        result.throughputDatesPerSec = 1e9 / result.averageTimeNs;
+    }
+
+private:
+    bool useHistogram_ = false;
+    std::vector<double> times_;
+    LogLinearHistogram histogram_;
+    double sum_ = 0.0;
+    size_t count_ = 0;
+};
+
+// ============================================================================
+// REPEATED TRIALS
+// ============================================================================
+// A trial is one full benchmark of a variant. Its mean and median are one
+// observation each. A trial is rejected when its median lies more than
+// OUTLIER_MAD_LIMIT scaled median absolute deviations from the median of all
+// trial medians (needs at least 3 trials). Confidence intervals are
+// percentile bootstraps over the kept trials.
+constexpr size_t BOOTSTRAP_RESAMPLES = 2000;
+constexpr double OUTLIER_MAD_LIMIT = 3.0;
+constexpr double MAD_TO_SIGMA = 1.4826;
+
+inline double medianOf(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    const double upper = values[mid];
+    if (values.size() % 2) {
+        return upper;
+    }
+    return (*std::max_element(values.begin(), values.begin() + mid) + upper) / 2.0;
+}
+
+inline double meanOf(const std::vector<double>& values) {
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+template<typename Statistic>
+ConfidenceInterval bootstrapInterval(const std::vector<double>& values, Statistic statistic, double confidence,
+                                     std::mt19937_64& rng) {
+    if (values.size() < 2) {
+        const double value = statistic(values);
+        return {value, value};
+    }
+    std::uniform_int_distribution<size_t> pick(0, values.size() - 1);
+    std::vector<double> resample(values.size());
+    std::vector<double> estimates(BOOTSTRAP_RESAMPLES);
+    for (double& estimate : estimates) {
+        for (double& value : resample) {
+            value = values[pick(rng)];
+        }
+        estimate = statistic(resample);
+    }
+    std::sort(estimates.begin(), estimates.end());
+    const double tail = (1.0 - confidence) / 2.0;
+    const double last = static_cast<double>(BOOTSTRAP_RESAMPLES - 1);
+    return {estimates[static_cast<size_t>(std::floor(tail * last))],
+            estimates[static_cast<size_t>(std::ceil((1.0 - tail) * last))]};
+}
+
+// Indices of the trials kept after outlier rejection.
+inline std::vector<size_t> keptTrials(const std::vector<double>& medians) {
+    std::vector<size_t> kept(medians.size());
+    std::iota(kept.begin(), kept.end(), size_t{0});
+    if (medians.size() < 3) {
+        return kept;
+    }
+    const double center = medianOf(medians);
+    std::vector<double> deviations;
+    for (const double m : medians) {
+        deviations.push_back(std::abs(m - center));
+    }
+    const double limit = OUTLIER_MAD_LIMIT * MAD_TO_SIGMA * medianOf(deviations);
+    if (limit <= 0.0) {
+        return kept;
+    }
+    std::erase_if(kept, [&](size_t t) { return std::abs(medians[t] - center) > limit; });
+    return kept;
+}
+
+// One result from the trials of a variant. Counters, memory and thread stats
+// come from the kept trial whose median is closest to the combined median.
+// Mean, median and percentiles are combined over the kept trials (mean of
+// means, median of medians and percentiles), and min/max span all of them.
+inline BenchmarkResult combineTrials(std::vector<BenchmarkResult>& trials, const BenchmarkConfig& config) {
+    if (trials.size() == 1) {
+        BenchmarkResult& only = trials.front();
+        only.trials.median = {only.medianTimeNs, only.medianTimeNs};
+        only.trials.mean = {only.averageTimeNs, only.averageTimeNs};
+        return only;
+    }
+
+    std::vector<double> medians;
+    for (const auto& t : trials) {
+        medians.push_back(t.medianTimeNs);
+    }
+    const std::vector<size_t> kept = keptTrials(medians);
+
+    std::vector<double> keptMeans, keptMedians, keptP95, keptP99;
+    for (const size_t t : kept) {
+        keptMeans.push_back(trials[t].averageTimeNs);
+        keptMedians.push_back(trials[t].medianTimeNs);
+        keptP95.push_back(trials[t].percentile95Ns);
+        keptP99.push_back(trials[t].percentile99Ns);
+    }
+    const double median = medianOf(keptMedians);
+    const size_t representative = *std::min_element(kept.begin(), kept.end(), [&](size_t a, size_t b) {
+        return std::abs(trials[a].medianTimeNs - median) < std::abs(trials[b].medianTimeNs - median);
+    });
+
+    BenchmarkResult result = trials[representative];
+    // Outliers of every trial, including the rejected ones.
+    result.tail = TailReport();
+    result.tail.thresholdNs = trials[representative].tail.thresholdNs;
+    for (size_t t = 0; t < trials.size(); ++t) {
+        for (TailEvent& event : trials[t].tail.events) {
+            event.trial = t + 1;
+        }
+        result.tail.merge(std::move(trials[t].tail));
+    }
+    result.averageTimeNs = meanOf(keptMeans);
+    result.medianTimeNs = median;
+    result.percentile95Ns = medianOf(keptP95);
+    result.percentile99Ns = medianOf(keptP99);
+    result.throughputDatesPerSec = 1e9 / result.averageTimeNs;
+    for (const size_t t : kept) {
+        result.minTimeNs = std::min(result.minTimeNs, trials[t].minTimeNs);
+        result.maxTimeNs = std::max(result.maxTimeNs, trials[t].maxTimeNs);
+    }
+
+    result.trials.count = trials.size();
+    result.trials.rejected = trials.size() - kept.size();
+    for (const auto& t : trials) {
+        result.correctnessCheck &= t.correctnessCheck;
+        result.discrepancies = std::max(result.discrepancies, t.discrepancies);
+        if (t.trials.minMHz > 0.0) {
+            result.trials.minMHz = result.trials.minMHz > 0.0 ? std::min(result.trials.minMHz, t.trials.minMHz) : t.trials.minMHz;
+            result.trials.maxMHz = std::max(result.trials.maxMHz, t.trials.maxMHz);
+        }
+    }
+
+    std::mt19937_64 rng(config.trialSeed ^ std::hash<std::string>{}(result.versionName));
+    result.trials.median = bootstrapInterval(keptMedians, [](const std::vector<double>& v) { return medianOf(v); },
+                                             config.confidenceLevel, rng);
+    result.trials.mean = bootstrapInterval(keptMeans, meanOf, config.confidenceLevel, rng);
+    return result;
+}
+
+// ============================================================================
+// MULTITHREADED EXECUTION
+// ============================================================================
+// CPUs this process may run on, in order.
+inline std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+// Pins the calling thread to one CPU. Returns the CPU, or -1 if pinning is
+// unsupported or failed.
+inline int pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) {
+        return -1;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? cpu : -1;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+struct ShardedRun {
+    SampleStats stats;
+    std::vector<ThreadRunStats> threads;
+    size_t calls = 0;
+    PerfCounts perf;                    // Summed over workers
+};
+
+// Splits [0, corpusSize) into threadCount contiguous shards and runs
+// worker(begin, end, calls, stats) -> callsDone on each, with totalCalls
+// divided evenly (the first totalCalls % threadCount workers get one more).
+// In single-threaded mode (config.threadCount == 1) the work runs on the
+// calling thread without pinning; otherwise every shard gets a pinned
+// std::jthread and all workers start together. Per-thread statistics
+// and hardware counters are merged at the end. The counters cover the whole
+// worker call, timing reads included, so in per-call mode they carry the
+// clock overhead; --timing=batch amortizes it.
+template<typename Worker>
+ShardedRun runSharded(const BenchmarkConfig& config, size_t threadCount, size_t corpusSize,
+                      size_t totalCalls, size_t callsPerSample, Worker worker) {
+    corpusSize = std::max<size_t>(1, corpusSize);
+    threadCount = std::max<size_t>(1, std::min({threadCount, corpusSize, totalCalls}));
+    callsPerSample = std::max<size_t>(1, callsPerSample);
+    const bool useHistogram = SampleStats::wantsHistogram(config, totalCalls / callsPerSample);
+
+    std::vector<SampleStats> stats;
+    stats.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; ++t) {
+        stats.emplace_back(useHistogram, (totalCalls / threadCount + 1) / callsPerSample);
+    }
+    std::vector<ThreadRunStats> threadStats(threadCount);
+    std::vector<PerfCounts> perf(threadCount);
+
+    auto body = [&](size_t t) {
+        const size_t begin = corpusSize * t / threadCount;
+        const size_t end = corpusSize * (t + 1) / threadCount;
+        PerfCounterGroup counters(config.perfCounters);
+        const auto start = std::chrono::steady_clock::now();
+        counters.start();
+        const size_t calls = totalCalls / threadCount + (t < totalCalls % threadCount ? 1 : 0);
+        threadStats[t].calls = worker(begin, end, calls, stats[t]);
+        perf[t] = counters.stop();
+        threadStats[t].wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        threadStats[t].throughputDatesPerSec = stats[t].count() ? 1e9 / stats[t].mean() : 0.0;
+    };
+
+    if (config.threadCount <= 1) {
+        body(0);
+    } else {
+        const std::vector<int> cpus = allowedCpus();
+        std::latch ready(static_cast<std::ptrdiff_t>(threadCount));
+        std::vector<std::jthread> workers;
+        workers.reserve(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&, t] {
+                threadStats[t].cpu = pinCurrentThread(cpus.empty() ? -1 : cpus[t % cpus.size()]);
+                ready.arrive_and_wait();
+                body(t);
+            });
+        }
+    }
+
+    ShardedRun run{std::move(stats[0]), std::move(threadStats), 0, perf[0]};
+    for (size_t t = 1; t < stats.size(); ++t) {
+        run.stats.merge(stats[t]);
+        run.perf.merge(perf[t]);
+    }
+    for (const auto& ts : run.threads) {
+        run.calls += ts.calls;
+    }
+    return run;
+}
+
+// Fills timing, thread and scaling fields of a result from a sharded run and,
+// for multithreaded runs, the single-worker reference throughput.
+template<typename Result>
+void fillShardedResult(Result& result, ShardedRun& run, double referenceThroughput) {
+    run.stats.fill(result);
+    result.iterations = run.calls;
+    result.threadCount = run.threads.size();
+    result.threadStats = run.threads;
+    result.perf = run.perf;
+    if (run.threads.size() > 1) {
+        double aggregate = 0.0;
+        for (const auto& ts : run.threads) {
+            aggregate += ts.throughputDatesPerSec;
+        }
+        result.throughputDatesPerSec = aggregate;
+        result.scalingEfficiency = referenceThroughput > 0.0 ? aggregate / (run.threads.size() * referenceThroughput) : 0.0;
+    }
+}
+
+// ============================================================================
+// BENCHMARK FUNCTION
+// ============================================================================
+template<typename Result>
+void reportDiscrepancy(Result& result, const TestCorpus& testData, size_t index, int expected, int actual,
+                       const BenchmarkConfig& config) {
+    result.correctnessCheck = false;
+    result.discrepancies++;
+    if (config.verboseOutput && result.discrepancies <= 5) {
+        std::cout << "\n    DISCREPANCY: " << testData.description(index)
+                  << " Year=" << testData.year(index)
+                  << " Day=" << testData.dayOfYear(index)
+                  << " Original=" << expected
+                  << " " << result.versionName << "=" << actual;
+    }
+}
+
+// Median cost of one timing sample with nothing inside it, in ns per call.
+// For batch mode this is the empty loop (index wrap + volatile store) divided
+// by the batch size.
+inline double measureTimerOverheadNs(BenchmarkConfig::TimingMode mode, size_t batchSize) {
+    using TimingMode = BenchmarkConfig::TimingMode;
+    constexpr size_t SAMPLES = 10001;
+    std::vector<double> samples;
+    samples.reserve(SAMPLES);
+
+    if (mode == TimingMode::Batch) {
+        batchSize = std::max<size_t>(1, batchSize);
+        size_t index = 0;
+        for (size_t i = 0; i < SAMPLES / 10; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t j = 0; j < batchSize; ++j) {
+                volatile size_t sink = index;
+                (void)sink;
+                if (++index >= batchSize) {
+                    index = 0;
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / batchSize);
+        }
+    } else if (mode == TimingMode::Rdtsc) {
+        const double nsPerTick = CycleTimer::nsPerTick();
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            const uint64_t start = CycleTimer::begin();
+            const uint64_t end = CycleTimer::end();
+            samples.push_back(static_cast<double>(end - start) * nsPerTick);
+        }
+    } else {
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto end = std::chrono::high_resolution_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+// Runs `calls` timed calls of func(input(i)) with i cycling over [begin, end)
+// and records the samples. Returns the number of calls made (batch mode
+// rounds down to whole batches). RecordTail also feeds every sample to tail.
+template<bool RecordTail, typename Func, typename Input>
+size_t runTimedCallsImpl(Func func, Input input, size_t begin, size_t end, size_t calls,
+                         BenchmarkConfig::TimingMode mode, size_t batchSize, double overheadNs,
+                         SampleStats& stats, TailRecorder* tail) {
+    using TimingMode = BenchmarkConfig::TimingMode;
+    const size_t shardSize = end - begin;
+
+    if (mode == TimingMode::Batch) {
+        // ===============================================================
+        // BATCH MODE (one clock read pair per timingBatchSize calls)
+        // ===============================================================
+        batchSize = std::max<size_t>(1, batchSize);
+        const size_t sampleCount = std::max<size_t>(1, calls / batchSize);
+        size_t testDataIndex = begin;
+
+        for (size_t i = 0; i < sampleCount; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            for (size_t j = 0; j < batchSize; ++j) {
+                volatile auto week = benchmarkSink(func(input(testDataIndex)));
+                (void)week;
+
+                testDataIndex++;
+                if (testDataIndex >= end) {
+                    testDataIndex = begin;
+                }
+            }
+
+            auto stop = std::chrono::high_resolution_clock::now();
+            double elapsed_ns = std::chrono::duration<double, std::nano>(stop - start).count() / batchSize;
+            const double sampleNs = std::max(0.0, elapsed_ns - overheadNs);
+            stats.add(sampleNs);
+            if constexpr (RecordTail) {
+                tail->sample(sampleNs);
+            }
+        }
+        return sampleCount * batchSize;
+    }
+
+    if (mode == TimingMode::Rdtsc) {
+        // ===============================================================
+        // RDTSC MODE (serialized cycle counter around every call)
+        // ===============================================================
+        const double nsPerTick = CycleTimer::nsPerTick();
+        for (size_t i = 0; i < calls; ++i) {
+            const auto& arg = input(begin + i % shardSize);
+
+            const uint64_t start = CycleTimer::begin();
+            volatile auto week = benchmarkSink(func(arg));
+            const uint64_t stop = CycleTimer::end();
+
+            const double sampleNs = std::max(0.0, static_cast<double>(stop - start) * nsPerTick - overheadNs);
+            stats.add(sampleNs);
+            if constexpr (RecordTail) {
+                tail->sample(sampleNs);
+            }
+            (void)week;
+        }
+        return calls;
+    }
+
+    // ===============================================================
+    // PER-CALL MODE
+    // ===============================================================
+    for (size_t i = 0; i < calls; ++i) {
+        const auto& arg = input(begin + i % shardSize);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        volatile auto week = benchmarkSink(func(arg));
+        auto stop = std::chrono::high_resolution_clock::now();
+
+        double elapsed_ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        const double sampleNs = std::max(0.0, elapsed_ns - overheadNs);
+        stats.add(sampleNs);
+        if constexpr (RecordTail) {
+            tail->sample(sampleNs);
+        }
+        (void)week;
+    }
+    return calls;
+}
+
+template<typename Func, typename Input>
+size_t runTimedCalls(Func func, Input input, size_t begin, size_t end, size_t calls,
+                     BenchmarkConfig::TimingMode mode, size_t batchSize, double overheadNs,
+                     SampleStats& stats, TailRecorder* tail = nullptr) {
+    if (tail) {
+        return runTimedCallsImpl<true>(func, input, begin, end, calls, mode, batchSize, overheadNs, stats, tail);
+    }
+    return runTimedCallsImpl<false>(func, input, begin, end, calls, mode, batchSize, overheadNs, stats, tail);
+}
+
+// Times func(input(i)) for every iteration; input(i) yields the argument for
+// test case i, so the same harness serves struct tm and epoch-based kernels.
+template<typename Func, typename Input>
+BenchmarkResult benchmarkInputFunction(
+    const std::string& name,
+    Func func,
+    Input input,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    BenchmarkResult result;
+    result.versionName = name;
     result.iterations = config.iterationCount;
     result.discrepancies = 0;
 
-    // Estimate stack usage
-    result.functionStackBytes = sizeof(struct tm) + 64; // rough estimate for local variables
+    // Estimate stack usage
+    result.functionStackBytes = sizeof(struct tm) + 64; // rough estimate for local variables
+
+    if (config.verboseOutput) {
+        std::cout << "  Testing " << name << "..." << std::flush;
+    }
+
+    // Capture memory (before)
+    if (config.trackMemory) {
+        result.memoryBefore.capture();
+    }
+
+    // Warm-up
+    for (size_t i = 0; i < 10000; ++i) {
+        volatile auto week = benchmarkSink(func(input(i % testData.size())));
+        (void)week;
+    }
+
+    // Benchmark
+    using TimingMode = BenchmarkConfig::TimingMode;
+    TimingMode mode = config.timingMode;
+    if (mode == TimingMode::Rdtsc && !CycleTimer::available()) {
+        mode = TimingMode::PerCall;
+    }
+    result.timingMode = timingModeName(mode);
+    result.timerOverheadNs = measureTimerOverheadNs(mode, config.timingBatchSize);
+    const double overheadNs = result.timerOverheadNs;
+    const size_t callsPerSample = mode == TimingMode::Batch ? std::max<size_t>(1, config.timingBatchSize) : 1;
+
+    TailCollector tails;
+    auto worker = [&](size_t begin, size_t end, size_t calls, SampleStats& stats) {
+        return tails.run(stats, calls / callsPerSample, [&](TailRecorder* tail) {
+            return runTimedCalls(func, input, begin, end, calls, mode, config.timingBatchSize, overheadNs, stats, tail);
+        });
+    };
+
+    double referenceThroughput = 0.0;
+    if (config.threadCount > 1) {
+        // One pinned worker doing one thread's share of calls on a shard of the same size.
+        ShardedRun single = runSharded(config, 1, testData.size() / config.threadCount,
+                                       (config.iterationCount + config.threadCount - 1) / config.threadCount,
+                                       callsPerSample, worker);
+        referenceThroughput = single.threads[0].throughputDatesPerSec;
+    }
+
+    tails.enable(config);
+    ShardedRun run = runSharded(config, config.threadCount, testData.size(), config.iterationCount, callsPerSample, worker);
+    fillShardedResult(result, run, referenceThroughput);
+    result.tail = tails.take();
+
+    // Capture memory (after)
+    if (config.trackMemory) {
+        result.memoryAfter.capture();
+    }
+
+    // Correctness check
+    result.correctnessCheck = true;
+    for (size_t i = 0; i < testData.size(); ++i) {
+        const auto res = func(input(i));
+        const struct tm reference = testData.timeStruct(i);
+        if (!matchesReference(reference, res)) {
+            reportDiscrepancy(result, testData, i, convertGregorianDateToWeekDate_Original(reference),
+                              weekOf(res), config);
+        }
+    }
+
+    if (config.verboseOutput) {
+        std::cout << " Done!" << std::endl;
+    }
+
+    return result;
+}
+
+template<typename Func>
+BenchmarkResult benchmarkFunction(
+    const std::string& name,
+    Func func,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    return benchmarkInputFunction(name, func,
+        [&testData](size_t i) -> const struct tm& { return testData.timeStructs[i]; }, testData, config);
+}
+
+// ============================================================================
+// BATCH BENCHMARK FUNCTION
+// ============================================================================
+// Each timing sample converts BATCH_CHUNK consecutive dates with one call;
+// the per-date time of a sample is its elapsed time divided by BATCH_CHUNK.
+constexpr size_t BATCH_CHUNK = 4096;
+
+// runRange(offset, count) converts corpus elements [offset, offset + count).
+// With several threads each worker times whole chunks inside its own shard.
+template<typename Result, typename RunRange>
+void timeBatchChunks(Result& result, size_t corpusSize, RunRange runRange, const BenchmarkConfig& config) {
+    const size_t threads = std::max<size_t>(1, config.threadCount);
+    const size_t chunk = std::max<size_t>(1, std::min(BATCH_CHUNK, corpusSize / threads));
+
+    TailCollector tails;
+    auto worker = [&](size_t begin, size_t end, size_t calls, SampleStats& stats) {
+        const size_t chunkCount = std::max<size_t>(1, (end - begin) / chunk);
+        const size_t sampleCount = std::max<size_t>(1, calls / chunk);
+
+        // Warm-up
+        for (size_t i = 0; i < std::min<size_t>(16, sampleCount); ++i) {
+            runRange(begin + (i % chunkCount) * chunk, chunk);
+        }
+
+        // One branch per chunk of BATCH_CHUNK dates, so no separate untraced loop.
+        tails.run(stats, sampleCount, [&](TailRecorder* tail) {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                const size_t offset = begin + (i % chunkCount) * chunk;
+                auto start = std::chrono::high_resolution_clock::now();
+                runRange(offset, chunk);
+                auto stop = std::chrono::high_resolution_clock::now();
+                const double sampleNs = std::chrono::duration<double, std::nano>(stop - start).count() / chunk;
+                stats.add(sampleNs);
+                if (tail) {
+                    tail->sample(sampleNs);
+                }
+            }
+            return sampleCount;
+        });
+        return sampleCount * chunk;
+    };
+
+    double referenceThroughput = 0.0;
+    if (threads > 1) {
+        ShardedRun single = runSharded(config, 1, corpusSize / threads, (config.iterationCount + threads - 1) / threads,
+                                       chunk, worker);
+        referenceThroughput = single.threads[0].throughputDatesPerSec;
+    }
+
+    tails.enable(config);
+    ShardedRun run = runSharded(config, threads, corpusSize, config.iterationCount, chunk, worker);
+    fillShardedResult(result, run, referenceThroughput);
+    result.tail = tails.take();
+
+    if (config.trackMemory) {
+        result.memoryAfter.capture();
+    }
+}
+
+BenchmarkResult beginBatchResult(const std::string& name, const BenchmarkConfig& config) {
+    BenchmarkResult result;
+    result.versionName = name;
+    result.discrepancies = 0;
+    result.functionStackBytes = 64;
+
+    if (config.verboseOutput) {
+        std::cout << "  Testing " << name << "..." << std::flush;
+    }
+
+    if (config.trackMemory) {
+        result.memoryBefore.capture();
+    }
+    return result;
+}
+
+template<typename OutT>
+BenchmarkResult benchmarkBatchFunction(
+    const std::string& name,
+    BatchFunc<OutT> func,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    auto result = beginBatchResult(name, config);
+
+    const std::span<const int16_t> years(testData.years);
+    const std::span<const int16_t> ydays(testData.ydays);
+    std::vector<OutT> weeks(testData.size());
+
+    timeBatchChunks(result, testData.size(), [&](size_t offset, size_t count) {
+        func(years.subspan(offset, count),
+             ydays.subspan(offset, count),
+             std::span<OutT>(weeks).subspan(offset, count));
+    }, config);
+
+    // Correctness check over the whole corpus in one call
+    func(years, ydays, weeks);
+    result.correctnessCheck = true;
+    for (size_t i = 0; i < testData.size(); ++i) {
+        const struct tm reference = testData.timeStruct(i);
+        if (!matchesReference(reference, weeks[i])) {
+            reportDiscrepancy(result, testData, i, convertGregorianDateToWeekDate_Original(reference),
+                              weekOf(weeks[i]), config);
+        }
+    }
+
+    if (config.verboseOutput) {
+        std::cout << " Done!" << std::endl;
+    }
+
+    return result;
+}
+
+// Batch benchmark over an arbitrary input column (e.g. epoch days) that is
+// aligned index-for-index with testData.
+template<typename InT>
+BenchmarkResult benchmarkColumnBatchFunction(
+    const std::string& name,
+    EpochBatchFunc<InT> func,
+    const std::vector<InT>& column,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    auto result = beginBatchResult(name, config);
+    std::vector<uint8_t> weeks(column.size());
+
+    timeBatchChunks(result, column.size(), [&](size_t offset, size_t count) {
+        func(std::span<const InT>(column).subspan(offset, count), std::span<uint8_t>(weeks).subspan(offset, count));
+    }, config);
+
+    func(column, weeks);
+    result.correctnessCheck = true;
+    for (size_t i = 0; i < testData.size(); ++i) {
+        const struct tm reference = testData.timeStruct(i);
+        if (!matchesReference(reference, static_cast<int>(weeks[i]))) {
+            reportDiscrepancy(result, testData, i, convertGregorianDateToWeekDate_Original(reference),
+                              weeks[i], config);
+        }
+    }
+
+    if (config.verboseOutput) {
+        std::cout << " Done!" << std::endl;
+    }
+
+    return result;
+}
+
+using TextDateFunc = TextDateStats (*)(std::string_view, std::span<uint8_t>, bool) noexcept;
+
+// Batch benchmark over fixed-width "YYYY-MM-DD\n" lines aligned with testData.
+BenchmarkResult benchmarkTextFunction(
+    const std::string& name,
+    TextDateFunc func,
+    const std::string& text,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    auto result = beginBatchResult(name, config);
+    result.inputBytesPerConversion = ISO_DATE_LINE_BYTES;
+    std::vector<uint8_t> weeks(testData.size());
+
+    timeBatchChunks(result, testData.size(), [&](size_t offset, size_t count) {
+        func(std::string_view(text).substr(offset * ISO_DATE_LINE_BYTES, count * ISO_DATE_LINE_BYTES),
+             std::span<uint8_t>(weeks).subspan(offset, count), true);
+    }, config);
+
+    func(text, weeks, true);
+    result.correctnessCheck = true;
+    for (size_t i = 0; i < testData.size(); ++i) {
+        const struct tm reference = testData.timeStruct(i);
+        if (!matchesReference(reference, static_cast<int>(weeks[i]))) {
+            reportDiscrepancy(result, testData, i, convertGregorianDateToWeekDate_Original(reference),
+                              weeks[i], config);
+        }
+    }
+
+    if (config.verboseOutput) {
+        std::cout << " Done!" << std::endl;
+    }
+
+    return result;
+}
+
+// Batch benchmark of reverse kernels over the packed ISO week dates of the
+// corpus; output is epoch days or year/yday columns.
+template<auto Kernel>
+BenchmarkResult benchmarkReverseBatchFunction(
+    const std::string& name,
+    const std::vector<uint32_t>& packed,
+    const TestCorpus& testData,
+    const BenchmarkConfig& config
+) {
+    constexpr bool yearDays = std::tuple_size_v<typename FunctionArgs<decltype(Kernel)>::type> == 3;
+    auto result = beginBatchResult(name, config);
+    const std::span<const uint32_t> in(packed);
+    std::vector<int32_t> days(yearDays ? 0 : packed.size());
+    std::vector<int16_t> years(yearDays ? packed.size() : 0);
+    std::vector<int16_t> ydays(yearDays ? packed.size() : 0);
+    auto runRange = [&](size_t offset, size_t count) {
+        if constexpr (yearDays) {
+            Kernel(in.subspan(offset, count), std::span<int16_t>(years).subspan(offset, count),
+                   std::span<int16_t>(ydays).subspan(offset, count));
+        } else {
+            Kernel(in.subspan(offset, count), std::span<int32_t>(days).subspan(offset, count));
+        }
+    };
+
+    timeBatchChunks(result, packed.size(), runRange, config);
+
+    runRange(0, packed.size());
+    result.correctnessCheck = true;
+    for (size_t i = 0; i < testData.size(); ++i) {
+        const struct tm reference = testData.timeStruct(i);
+        const int64_t day = yearDays ? daysFromYearDay(years[i], ydays[i]) : days[i];
+        if (!matchesReference(reference, day)) {
+            reportDiscrepancy(result, testData, i, convertGregorianDateToWeekDate_Original(reference), weekOf(day), config);
+        }
+    }
+
+    if (config.verboseOutput) {
+        std::cout << " Done!" << std::endl;
+    }
+
+    return result;
+}
+
+// ============================================================================
+// WORKING-SET SWEEP
+// ============================================================================
+// Times one conversion per record over working sets from SWEEP_MIN_BYTES to
+// config.sweepMaxBytes, doubling each step. Three series run at every step:
+// the array-of-structs record the corpus used before it was split into
+// columns, V4 per record over the year/yday columns, and the dispatched
+// convertWeekDates() over the same columns. A series' working set is its
+// record count times the bytes one conversion touches (record stride, plus
+// the week byte written by the batch kernel), so all series have the same
+// footprint at each step. Records are visited in order, as in the benchmark,
+// so sizes beyond the last-level cache measure prefetched streaming.
+constexpr size_t SWEEP_MIN_BYTES = size_t{4} << 10;
+constexpr size_t SWEEP_SAMPLE_CONVERSIONS = size_t{1} << 16;    // Minimum per timing sample
+constexpr size_t SWEEP_TARGET_CONVERSIONS = size_t{1} << 24;    // Per step and series
+constexpr size_t SWEEP_MIN_SAMPLES = 3;
+
+// The original per-case record: struct tm plus copies of its year and day and
+// a description.
+struct SweepTestCase {
+    struct tm timeStruct;
+    int year;
+    int dayOfYear;
+    std::string description;
+};
+
+// Cache sizes in bytes (0: unknown).
+struct CacheSizes {
+    long l1d = 0;
+    long l2 = 0;
+    long l3 = 0;
+
+    static CacheSizes detect() {
+        CacheSizes sizes;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+        sizes.l1d = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        sizes.l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        sizes.l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        return sizes;
+    }
+
+    // Smallest level the working set fits in.
+    const char* levelFor(size_t bytes) const {
+        if (l1d <= 0) {
+            return "?";
+        }
+        if (bytes <= static_cast<size_t>(l1d)) return "L1";
+        if (l2 > 0 && bytes <= static_cast<size_t>(l2)) return "L2";
+        if (l3 > 0 && bytes <= static_cast<size_t>(l3)) return "L3";
+        return "DRAM";
+    }
+};
+
+struct SweepPoint {
+    std::string layout;
+    std::string kernel;
+    size_t workingSetBytes = 0;
+    size_t records = 0;
+    size_t bytesPerConversion = 0;
+    double nsPerConversion = 0.0;
+
+    double gbPerSecond() const { return nsPerConversion > 0.0 ? bytesPerConversion / nsPerConversion : 0.0; }
+};
+
+// Median ns per record over timed samples of whole passes; pass() converts
+// every record once. The first pass is an untimed warm-up.
+template<typename Pass>
+double timeSweepPasses(size_t records, Pass pass) {
+    const size_t passesPerSample = std::max<size_t>(1, SWEEP_SAMPLE_CONVERSIONS / records);
+    const size_t samples = std::max(SWEEP_MIN_SAMPLES, SWEEP_TARGET_CONVERSIONS / (passesPerSample * records));
+    pass();
+
+    std::vector<double> perRecordNs;
+    perRecordNs.reserve(samples);
+    for (size_t s = 0; s < samples; ++s) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t p = 0; p < passesPerSample; ++p) {
+            pass();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        perRecordNs.push_back(std::chrono::duration<double, std::nano>(stop - start).count()
+                              / static_cast<double>(passesPerSample * records));
+    }
+    return medianOf(std::move(perRecordNs));
+}
+
+// Uniform dates over [minYear, maxYear]; emit(i, year, zero-based yday).
+template<typename Emit>
+void generateSweepDates(size_t count, int minYear, int maxYear, Emit emit) {
+    std::mt19937_64 rng(0x5eedULL + count);
+    std::uniform_int_distribution<int> yearDist(minYear, maxYear);
+    for (size_t i = 0; i < count; ++i) {
+        const int year = yearDist(rng);
+        const int yday = static_cast<int>(rng() % static_cast<uint64_t>(daysInYear(year)));
+        emit(i, year, yday);
+    }
+}
+
+inline std::vector<SweepPoint> runWorkingSetSweep(const BenchmarkConfig& config) {
+    const char* batchKernel = nullptr;
+    selectBatchKernel(&batchKernel);
+    const std::string batchName = std::string("convertWeekDates (") + batchKernel + ")";
+    volatile unsigned sink = 0;
+
+    std::vector<SweepPoint> points;
+    for (size_t bytes = SWEEP_MIN_BYTES; bytes <= config.sweepMaxBytes; bytes *= 2) {
+        {
+            SweepPoint point{"AoS TestCase", "V4 per record", bytes, 0, sizeof(SweepTestCase), 0.0};
+            point.records = std::max<size_t>(1, bytes / point.bytesPerConversion);
+            std::vector<SweepTestCase> cases(point.records);
+            generateSweepDates(point.records, config.minYear, config.maxYear, [&](size_t i, int year, int yday) {
+                std::memset(&cases[i].timeStruct, 0, sizeof(struct tm));
+                cases[i].timeStruct.tm_year = year - 1900;
+                cases[i].timeStruct.tm_yday = yday;
+                cases[i].year = year;
+                cases[i].dayOfYear = yday + 1;
+                cases[i].description = "Random";
+            });
+            point.nsPerConversion = timeSweepPasses(point.records, [&] {
+                unsigned sum = 0;
+                for (const SweepTestCase& c : cases) {
+                    sum += static_cast<unsigned>(convertGregorianDateToWeekDate_V4(c.timeStruct));
+                }
+                sink = sum;
+            });
+            points.push_back(point);
+        }
+
+        const size_t columnRecords = std::max<size_t>(1, bytes / (2 * sizeof(int16_t)));
+        const size_t batchRecords = std::max<size_t>(1, bytes / (2 * sizeof(int16_t) + sizeof(uint8_t)));
+        std::vector<int16_t> years(columnRecords);
+        std::vector<int16_t> ydays(columnRecords);
+        generateSweepDates(columnRecords, config.minYear, config.maxYear, [&](size_t i, int year, int yday) {
+            years[i] = static_cast<int16_t>(year);
+            ydays[i] = static_cast<int16_t>(yday);
+        });
+        {
+            SweepPoint point{"SoA columns", "V4 per record", bytes, columnRecords, 2 * sizeof(int16_t), 0.0};
+            point.nsPerConversion = timeSweepPasses(point.records, [&] {
+                unsigned sum = 0;
+                for (size_t i = 0; i < columnRecords; ++i) {
+                    sum += static_cast<unsigned>(weekNumber_V4(years[i], ydays[i] + 1));
+                }
+                sink = sum;
+            });
+            points.push_back(point);
+        }
+        {
+            SweepPoint point{"SoA columns", batchName, bytes, batchRecords, 2 * sizeof(int16_t) + sizeof(uint8_t), 0.0};
+            std::vector<uint8_t> weeks(batchRecords);
+            const std::span<const int16_t> yearSpan(years.data(), batchRecords);
+            const std::span<const int16_t> ydaySpan(ydays.data(), batchRecords);
+            point.nsPerConversion = timeSweepPasses(point.records, [&] {
+                convertWeekDates(yearSpan, ydaySpan, weeks);
+                sink = weeks[batchRecords / 2];
+            });
+            points.push_back(point);
+        }
+
+        if (config.verboseOutput) {
+            std::cout << "  " << bytes / 1024 << " KB done" << std::endl;
+        }
+    }
+    (void)sink;
+    return points;
+}
+
+inline void printWorkingSetSweep(const std::vector<SweepPoint>& points, const CacheSizes& caches) {
+    std::cout << std::left << std::setw(13) << "Working set" << std::setw(7) << "Level" << std::setw(14) << "Layout"
+              << std::setw(32) << "Kernel" << std::right << std::setw(8) << "B/conv" << std::setw(10) << "ns/conv"
+              << std::setw(9) << "GB/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const SweepPoint& p : points) {
+        const std::string size = p.workingSetBytes >= (size_t{1} << 20)
+            ? std::to_string(p.workingSetBytes >> 20) + " MB" : std::to_string(p.workingSetBytes >> 10) + " KB";
+        std::cout << std::left << std::setw(13) << size << std::setw(7) << caches.levelFor(p.workingSetBytes)
+                  << std::setw(14) << p.layout << std::setw(32) << p.kernel << std::right
+                  << std::setw(8) << p.bytesPerConversion << std::setw(10) << p.nsPerConversion
+                  << std::setw(9) << p.gbPerSecond() << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+inline void writeWorkingSetSweepCsv(const std::vector<SweepPoint>& points, const CacheSizes& caches, const char* path) {
+    std::ofstream csv(path);
+    csv << "Layout,Kernel,Working_set_bytes,Level,Records,Bytes_per_conversion,ns_per_conversion,GB_per_s\n";
+    for (const SweepPoint& p : points) {
+        csv << p.layout << ","
+            << p.kernel << ","
+            << p.workingSetBytes << ","
+            << caches.levelFor(p.workingSetBytes) << ","
+            << p.records << ","
+            << p.bytesPerConversion << ","
+            << p.nsPerConversion << ","
+            << p.gbPerSecond() << "\n";
+    }
+}
+
+// ============================================================================
+// GROUP BY ISO WEEK
+// ============================================================================
+// Count, sum, min and max of an int64 value column per ISO week of a date
+// column (epoch days or seconds). ISO weeks run Monday to Sunday, so with
+// firstMonday the Monday of week 1 of minIsoYear, (day - firstMonday) / 7 is
+// a dense index over every week of ISO years [minIsoYear, maxIsoYear]: the
+// conversion of a row is one subtraction and one unsigned multiply-shift, and
+// the ISO year and week are converted once per non-empty bucket, from its
+// Monday, when the groups are built. Rows outside the range wrap to an index
+// past the end and are counted, not aggregated.
+//
+// Every forEachFileChunkOnWorkers() worker fills a histogram of its own over
+// the whole range, allocated and first touched by that worker, so no bucket
+// is written by two threads. After the join the histograms are added into the
+// first one bucket by bucket, which costs buckets x threads, independent of
+// the row count. Without a value column the buckets are plain counts, a
+// quarter of the footprint (1800-3000: 63K weeks, 0.5 MB instead of 2 MB).
+constexpr size_t AGGREGATE_REPETITIONS = 5;          // Runs per approach; the median time is reported
+constexpr int64_t AGGREGATE_MAX_VALUE = 999999;      // Generated values are uniform in [0, this]
+
+struct WeekAggregate {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int64_t min = std::numeric_limits<int64_t>::max();
+    int64_t max = std::numeric_limits<int64_t>::min();
+
+    void add(int64_t value) noexcept
+    {
+        ++count;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const WeekAggregate& other) noexcept
+    {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    bool operator==(const WeekAggregate&) const = default;
+};
+
+struct IsoWeekGroup {
+    IsoWeekDate week;                   // Weekday 1
+    WeekAggregate aggregate;            // Only count is set without a value column
+};
+
+struct WeekAggregation {
+    std::vector<IsoWeekGroup> groups;   // Non-empty weeks in calendar order
+    size_t rows = 0;
+    size_t outOfRange = 0;              // Rows of no week in the range, in no group
+    size_t threads = 0;
+    double seconds = 0.0;               // From the first row to the finished groups
+
+    double rowsPerSecond() const { return seconds > 0.0 ? static_cast<double>(rows) / seconds : 0.0; }
+};
+
+inline int64_t aggregationDay(int32_t days) noexcept { return days; }
+inline int64_t aggregationDay(int64_t seconds) noexcept { return floorDaysFromSeconds(seconds); }
+
+template<bool WithValues>
+using WeekBucket = std::conditional_t<WithValues, WeekAggregate, uint64_t>;
+
+// Adds dates[i] (and values[i]) to buckets; returns the rows out of range.
+template<bool WithValues, typename InT>
+size_t accumulateWeeks(std::span<const InT> dates, const int64_t* values, int64_t firstMonday,
+                       std::span<WeekBucket<WithValues>> buckets) noexcept
+{
+    size_t outside = 0;
+    for (size_t i = 0; i < dates.size(); ++i) {
+        const uint64_t bucket = static_cast<uint64_t>(aggregationDay(dates[i]) - firstMonday) / 7;
+        if (bucket >= buckets.size()) {
+            ++outside;
+        } else if constexpr (WithValues) {
+            buckets[bucket].add(values[i]);
+        } else {
+            ++buckets[bucket];
+        }
+    }
+    return outside;
+}
+
+template<bool WithValues, typename InT>
+WeekAggregation aggregateByIsoWeekImpl(std::span<const InT> dates, std::span<const int64_t> values,
+                                       int minIsoYear, int maxIsoYear, size_t threads)
+{
+    using Bucket = WeekBucket<WithValues>;
+    const int64_t firstMonday = isoWeekEpochDays(minIsoYear, 1).first;
+    const int64_t lastSunday = isoWeekEpochDays(maxIsoYear, isoWeeksInYear(maxIsoYear)).last;
+    const size_t bucketCount = static_cast<size_t>(lastSunday - firstMonday + 1) / 7;
+
+    WeekAggregation result;
+    result.rows = dates.size();
+    result.threads = fileChunkWorkers(dates.size(), threads);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<Bucket>> histograms(result.threads);
+    std::vector<size_t> outside(result.threads);
+    forEachFileChunkOnWorkers(dates.size(), threads, [&](size_t worker, size_t begin, size_t end, size_t) {
+        std::vector<Bucket>& histogram = histograms[worker];
+        if (histogram.empty()) {
+            histogram.resize(bucketCount);
+        }
+        outside[worker] += accumulateWeeks<WithValues>(dates.subspan(begin, end - begin),
+                                                       WithValues ? values.data() + begin : nullptr,
+                                                       firstMonday, std::span<Bucket>(histogram));
+    });
+
+    std::vector<Bucket>& total = histograms[0];
+    total.resize(bucketCount);                      // No-op unless worker 0 got no chunk
+    for (size_t t = 1; t < histograms.size(); ++t) {
+        for (size_t b = 0; b < histograms[t].size(); ++b) {
+            if constexpr (WithValues) {
+                total[b].merge(histograms[t][b]);
+            } else {
+                total[b] += histograms[t][b];
+            }
+        }
+    }
+    for (size_t b = 0; b < bucketCount; ++b) {
+        WeekAggregate aggregate;
+        if constexpr (WithValues) {
+            aggregate = total[b];
+        } else {
+            aggregate.count = total[b];
+        }
+        if (aggregate.count != 0) {
+            result.groups.push_back({convertEpochDaysToIsoWeekDate(firstMonday + 7 * static_cast<int64_t>(b)), aggregate});
+        }
+    }
+    result.outOfRange = std::accumulate(outside.begin(), outside.end(), size_t{0});
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// Groups dates (int32 epoch days or int64 Unix seconds) by ISO week of ISO
+// years [minIsoYear, maxIsoYear] on up to threads workers. values is empty
+// (count only) or has one value per date; sums must fit in int64.
+template<typename InT>
+WeekAggregation aggregateByIsoWeek(std::span<const InT> dates, std::span<const int64_t> values,
+                                   int minIsoYear, int maxIsoYear, size_t threads)
+{
+    return values.empty() ? aggregateByIsoWeekImpl<false>(dates, values, minIsoYear, maxIsoYear, threads)
+                          : aggregateByIsoWeekImpl<true>(dates, values, minIsoYear, maxIsoYear, threads);
+}
+
+// Baseline: the whole column converted to full ISO week dates first, then
+// grouped in a std::unordered_map keyed by the packed ISO year and week, on
+// one thread.
+template<typename InT>
+WeekAggregation aggregateByIsoWeek_UnorderedMap(std::span<const InT> dates, std::span<const int64_t> values,
+                                                int minIsoYear, int maxIsoYear)
+{
+    WeekAggregation result;
+    result.rows = dates.size();
+    result.threads = 1;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<uint32_t> keys(dates.size());
+    for (size_t i = 0; i < dates.size(); ++i) {
+        keys[i] = packIsoWeekDate(convertEpochDaysToIsoWeekDate(aggregationDay(dates[i]))) & ~uint32_t{0xFF};
+    }
+    std::unordered_map<uint32_t, WeekAggregate> groups;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const int isoYear = unpackIsoWeekDate(keys[i]).isoYear;
+        if (isoYear < minIsoYear || isoYear > maxIsoYear) {
+            ++result.outOfRange;
+            continue;
+        }
+        WeekAggregate& aggregate = groups[keys[i]];
+        if (values.empty()) {
+            ++aggregate.count;
+        } else {
+            aggregate.add(values[i]);
+        }
+    }
+    result.groups.reserve(groups.size());
+    for (const auto& [key, aggregate] : groups) {
+        result.groups.push_back({unpackIsoWeekDate(key | 1), aggregate});
+    }
+    std::sort(result.groups.begin(), result.groups.end(), [](const IsoWeekGroup& a, const IsoWeekGroup& b) {
+        return std::pair(a.week.isoYear, a.week.week) < std::pair(b.week.isoYear, b.week.week);
+    });
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// Same weeks, rows out of range and counts; sums, minima and maxima too
+// unless countsOnly.
+inline bool sameWeekAggregation(const WeekAggregation& a, const WeekAggregation& b, bool countsOnly)
+{
+    return a.outOfRange == b.outOfRange
+        && std::equal(a.groups.begin(), a.groups.end(), b.groups.begin(), b.groups.end(),
+                      [countsOnly](const IsoWeekGroup& x, const IsoWeekGroup& y) {
+                          return x.week == y.week && x.aggregate.count == y.aggregate.count
+                              && (countsOnly || x.aggregate == y.aggregate);
+                      });
+}
+
+// Date and value columns for the aggregation benchmark: days of the
+// distribution's generatorSpan(), in order (repeating) for Sorted and uniform
+// otherwise, and values uniform in [0, AGGREGATE_MAX_VALUE]. Every chunk has
+// its own generator, so the columns do not depend on the thread count.
+struct AggregationColumns {
+    CorpusColumn<int32_t> days;
+    CorpusColumn<int64_t> values;
+};
+
+inline AggregationColumns generateAggregationColumns(size_t rows, const BenchmarkConfig& config, size_t threads)
+{
+    AggregationColumns columns;
+    columns.days.resize(rows);
+    columns.values.resize(rows);
+    const GeneratorSpan span = generatorSpan(config);
+    const bool sorted = config.distribution == BenchmarkConfig::Distribution::Sorted;
+    forEachFileChunk(rows, threads, [&](size_t begin, size_t end, size_t chunk) {
+        std::seed_seq seed{GENERATOR_SEED, static_cast<uint32_t>(chunk), static_cast<uint32_t>(uint64_t(chunk) >> 32)};
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int64_t> dayDist(0, span.dayCount - 1);
+        std::uniform_int_distribution<int64_t> valueDist(0, AGGREGATE_MAX_VALUE);
+        for (size_t i = begin; i < end; ++i) {
+            const int64_t offset = sorted ? static_cast<int64_t>(i % static_cast<uint64_t>(span.dayCount)) : dayDist(gen);
+            columns.days[i] = static_cast<int32_t>(span.firstDay + offset);
+            columns.values[i] = valueDist(gen);
+        }
+    });
+    return columns;
+}
+
+struct AggregationTiming {
+    std::string approach;
+    size_t threads = 0;
+    double seconds = 0.0;               // Median of AGGREGATE_REPETITIONS runs
+    size_t rows = 0;
+    size_t groups = 0;
+    bool matches = true;                // Same result as the baseline
+
+    double rowsPerSecond() const { return seconds > 0.0 ? static_cast<double>(rows) / seconds : 0.0; }
+};
+
+template<typename Fn>
+AggregationTiming timeAggregation(std::string approach, Fn&& run, const WeekAggregation* reference, bool countsOnly)
+{
+    AggregationTiming timing;
+    timing.approach = std::move(approach);
+    std::vector<double> seconds;
+    for (size_t r = 0; r < AGGREGATE_REPETITIONS; ++r) {
+        const WeekAggregation result = run();
+        seconds.push_back(result.seconds);
+        if (r + 1 == AGGREGATE_REPETITIONS) {
+            timing.threads = result.threads;
+            timing.rows = result.rows;
+            timing.groups = result.groups.size();
+            timing.matches = !reference || sameWeekAggregation(result, *reference, countsOnly);
+        }
+    }
+    timing.seconds = medianOf(seconds);
+    return timing;
+}
+
+// Times the baseline and the dense histograms (one thread, all threads, and
+// count only) on one generated distribution and checks every result against
+// the baseline's. Returns false on a mismatch.
+inline bool runAggregationBenchmark(const BenchmarkConfig& config, size_t threads)
+{
+    const int minIsoYear = config.minYear - 1;      // Jan 1-3 can belong to the ISO year before,
+    const int maxIsoYear = config.maxYear + 1;      // Dec 29-31 to the one after
+    const AggregationColumns columns = generateAggregationColumns(config.aggregateRows, config, threads);
+    const std::span<const int32_t> days(columns.days);
+    const std::span<const int64_t> values(columns.values);
+
+    std::vector<AggregationTiming> timings;
+    const WeekAggregation baseline = aggregateByIsoWeek_UnorderedMap(days, values, minIsoYear, maxIsoYear);
+    timings.push_back(timeAggregation("Convert + unordered_map", [&] {
+        return aggregateByIsoWeek_UnorderedMap(days, values, minIsoYear, maxIsoYear);
+    }, &baseline, false));
+    std::vector<size_t> threadCounts = {1};
+    if (threads > 1) {
+        threadCounts.push_back(threads);
+    }
+    for (size_t t : threadCounts) {
+        timings.push_back(timeAggregation("Dense histogram", [&] {
+            return aggregateByIsoWeek(days, values, minIsoYear, maxIsoYear, t);
+        }, &baseline, false));
+    }
+    timings.push_back(timeAggregation("Dense histogram, count only", [&] {
+        return aggregateByIsoWeek(days, std::span<const int64_t>(), minIsoYear, maxIsoYear, threads);
+    }, &baseline, true));
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(30) << "Approach" << std::right << std::setw(8) << "Threads"
+              << std::setw(12) << "ms" << std::setw(14) << "M rows/s" << std::setw(10) << "Speedup"
+              << std::setw(9) << "Groups" << "  Result" << std::endl;
+    bool allMatch = true;
+    for (const AggregationTiming& t : timings) {
+        allMatch &= t.matches;
+        std::cout << "  " << std::left << std::setw(30) << t.approach << std::right << std::setw(8) << t.threads
+                  << std::setw(12) << t.seconds * 1e3 << std::setw(14) << t.rowsPerSecond() / 1e6
+                  << std::setw(9) << (t.seconds > 0.0 ? timings[0].seconds / t.seconds : 0.0) << "x"
+                  << std::setw(9) << t.groups << "  " << (t.matches ? "matches baseline" : "MISMATCH") << std::endl;
+    }
+    std::cout << "  Rows out of range: " << baseline.outOfRange << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    return allMatch;
+}
+
+// Counts the rows of a column file (--file-format) per ISO week of ISO years
+// [minYear - 1, maxYear + 1] and writes IsoYear,Week,Count rows to csvPath.
+// Returns an error message, empty on success.
+inline std::string aggregateColumnFile(const std::string& path, BenchmarkConfig::FileFormat format,
+                                       const BenchmarkConfig& config, size_t threads, const char* csvPath)
+{
+#ifdef __linux__
+    if constexpr (std::endian::native != std::endian::little) {
+        return "column files are little-endian; this host is not";
+    }
+    MappedFile input;
+    if (std::string error = input.openRead(path); !error.empty()) {
+        return error;
+    }
+    const size_t recordBytes = fileRecordBytes(format);
+    if (input.size() % recordBytes != 0) {
+        return path + ": size " + std::to_string(input.size()) + " is not a multiple of "
+               + std::to_string(recordBytes) + " (" + fileFormatName(format) + " records)";
+    }
+    input.advise(MADV_SEQUENTIAL);
+    const size_t records = input.size() / recordBytes;
+    const WeekAggregation result = format == BenchmarkConfig::FileFormat::EpochSeconds
+        ? aggregateByIsoWeek(std::span<const int64_t>(reinterpret_cast<const int64_t*>(input.data()), records), {},
+                             config.minYear - 1, config.maxYear + 1, threads)
+        : aggregateByIsoWeek(std::span<const int32_t>(reinterpret_cast<const int32_t*>(input.data()), records), {},
+                             config.minYear - 1, config.maxYear + 1, threads);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Records: " << result.rows << " (" << fileFormatName(format) << ", " << input.size() / 1e6
+              << " MB)" << std::endl;
+    std::cout << "  Threads: " << result.threads << std::endl;
+    std::cout << "  Aggregate: " << result.seconds * 1e3 << " ms, " << result.rowsPerSecond() / 1e6 << " M rows/s"
+              << std::endl;
+    std::cout << "  Weeks: " << result.groups.size() << ", rows out of range: " << result.outOfRange << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    std::ofstream csv(csvPath);
+    csv << "IsoYear,Week,Count\n";
+    for (const IsoWeekGroup& g : result.groups) {
+        csv << g.week.isoYear << "," << int(g.week.week) << "," << g.aggregate.count << "\n";
+    }
+    return csv ? std::string() : std::string("Cannot write ") + csvPath;
+#else
+    (void)path; (void)format; (void)config; (void)threads; (void)csvPath;
+    return "column files need mmap (Linux only)";
+#endif
+}
+
+// ============================================================================
+// PIPELINE (parse -> convert -> aggregate)
+// ============================================================================
+// Three stages with their own threads, connected by bounded lock-free
+// single-producer/single-consumer rings: every thread of a stage has one ring
+// to every thread of the next, so each ring has exactly one writer and one
+// reader. Batches of up to pipelineBatchRecords records move through the
+// rings by pointer. Each parse thread owns a fixed pool of batches that the
+// aggregate threads hand back over a third set of rings, so nothing is
+// allocated after start-up. A full output ring or an empty pool stalls the
+// producer (backpressure), which bounds the batches in flight.
+//
+//   parse:     "YYYY-MM-DD\n" lines -> year/yday columns (parseIsoDateLine)
+//   convert:   year/yday -> packed ISO week dates (convertIsoWeekDatesPacked)
+//   aggregate: rows per ISO week, one histogram per thread, added up after the join
+//
+// The text is cut into line-aligned slices of about one batch, handed out to
+// the parse threads by a shared counter. Every thread keeps its busy time and
+// its time waiting for input or for room downstream, and a consumer samples
+// the fill of its input rings on each pop. The stage with the lowest capacity
+// (records per busy second, times its threads) is the bottleneck; its input
+// rings run full and the rings after it run empty.
+constexpr size_t PIPELINE_WEEK_SLOTS = 53;          // Histogram slots per ISO year
+
+// Bounded single-producer/single-consumer ring. Head and tail are on separate
+// cache lines, and each side keeps a copy of the other's index so it only
+// reads the shared one when the ring looks full or empty.
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity)
+        : slots(std::bit_ceil(std::max<size_t>(minCapacity, 1))), mask(slots.size() - 1) {}
+
+    // Producer side.
+    bool tryPush(T value) noexcept
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == slots.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == slots.size()) {
+                return false;
+            }
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side; everything pushed before close() is still popped.
+    void close() noexcept { closed.store(true, std::memory_order_release); }
+
+    // Consumer side.
+    bool tryPop(T& value) noexcept
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) {
+                return false;
+            }
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: closed and empty.
+    bool drained() const noexcept
+    {
+        return closed.load(std::memory_order_acquire)
+            && tail.load(std::memory_order_acquire) == head.load(std::memory_order_relaxed);
+    }
+
+    // Either side; a snapshot for the metrics.
+    size_t size() const noexcept
+    {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+    }
+    size_t capacity() const noexcept { return slots.size(); }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};        // Written by the consumer
+    size_t cachedTail = 0;
+    alignas(64) std::atomic<size_t> tail{0};        // Written by the producer
+    size_t cachedHead = 0;
+    alignas(64) std::atomic<bool> closed{false};
+    std::vector<T> slots;
+    size_t mask;
+};
+
+struct PipelineBatch {
+    size_t owner;                       // Parse thread whose pool it belongs to
+    size_t records = 0;
+    std::vector<int16_t> years;
+    std::vector<int16_t> ydays;
+    std::vector<uint32_t> packed;
+    std::vector<uint32_t> invalid;      // Lines that are not a date; packed 0
+
+    PipelineBatch(size_t ownerIndex, size_t capacity)
+        : owner(ownerIndex), years(capacity), ydays(capacity), packed(capacity)
+    {
+        invalid.reserve(capacity);
+    }
+};
+
+using PipelineRing = SpscRing<PipelineBatch*>;
+
+// One ring from each of producers threads to each of consumers threads.
+class PipelineLink {
+public:
+    PipelineLink(size_t producerCount, size_t consumerCount, size_t depth)
+        : producers(producerCount), consumers(consumerCount)
+    {
+        for (size_t i = 0; i < producers * consumers; ++i) {
+            rings.push_back(std::make_unique<PipelineRing>(depth));
+        }
+    }
+
+    PipelineRing& at(size_t producer, size_t consumer) { return *rings[producer * consumers + consumer]; }
+
+    std::vector<PipelineRing*> outputsOf(size_t producer)
+    {
+        std::vector<PipelineRing*> out;
+        for (size_t c = 0; c < consumers; ++c) {
+            out.push_back(&at(producer, c));
+        }
+        return out;
+    }
+
+    std::vector<PipelineRing*> inputsOf(size_t consumer)
+    {
+        std::vector<PipelineRing*> in;
+        for (size_t p = 0; p < producers; ++p) {
+            in.push_back(&at(p, consumer));
+        }
+        return in;
+    }
+
+private:
+    size_t producers;
+    size_t consumers;
+    std::vector<std::unique_ptr<PipelineRing>> rings;
+};
+
+// Counters of one stage thread; summed per stage after the join.
+struct PipelineThreadStats {
+    size_t batches = 0;
+    size_t records = 0;
+    double busySeconds = 0.0;
+    double inputWaitSeconds = 0.0;      // Every input ring empty
+    double outputWaitSeconds = 0.0;     // Every output ring full, or no free batch
+    double queueFillSum = 0.0;          // Fill of the input rings (0-1) at each pop
+    double queueFillMax = 0.0;
+
+    void add(const PipelineThreadStats& other)
+    {
+        batches += other.batches;
+        records += other.records;
+        busySeconds += other.busySeconds;
+        inputWaitSeconds += other.inputWaitSeconds;
+        outputWaitSeconds += other.outputWaitSeconds;
+        queueFillSum += other.queueFillSum;
+        queueFillMax = std::max(queueFillMax, other.queueFillMax);
+    }
+};
+
+inline double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pops a batch from the first non-empty ring of inputs, starting after the one
+// popped last. Returns false once every ring is closed and drained.
+inline bool popBatch(const std::vector<PipelineRing*>& inputs, size_t& cursor, PipelineBatch*& batch,
+                     PipelineThreadStats& stats)
+{
+    std::chrono::steady_clock::time_point waitStart;
+    bool waiting = false;
+    for (;;) {
+        bool open = false;
+        for (size_t n = 0; n < inputs.size(); ++n) {
+            const size_t r = (cursor + n) % inputs.size();
+            if (inputs[r]->tryPop(batch)) {
+                cursor = r + 1;
+                size_t queued = 0;
+                size_t capacity = 0;
+                for (const PipelineRing* ring : inputs) {
+                    queued += ring->size();
+                    capacity += ring->capacity();
+                }
+                const double fill = static_cast<double>(queued + 1) / static_cast<double>(capacity);
+                stats.queueFillSum += fill;
+                stats.queueFillMax = std::max(stats.queueFillMax, fill);
+                if (waiting) {
+                    stats.inputWaitSeconds += secondsSince(waitStart);
+                }
+                return true;
+            }
+            open |= !inputs[r]->drained();
+        }
+        if (!open) {
+            if (waiting) {
+                stats.inputWaitSeconds += secondsSince(waitStart);
+            }
+            return false;
+        }
+        if (!waiting) {
+            waitStart = std::chrono::steady_clock::now();
+            waiting = true;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// Pushes batch to the first ring of outputs with room, starting after the one
+// pushed to last, and waits while all of them are full.
+inline void pushBatch(const std::vector<PipelineRing*>& outputs, size_t& cursor, PipelineBatch* batch,
+                      PipelineThreadStats& stats)
+{
+    std::chrono::steady_clock::time_point waitStart;
+    bool waiting = false;
+    for (;;) {
+        for (size_t n = 0; n < outputs.size(); ++n) {
+            const size_t r = (cursor + n) % outputs.size();
+            if (outputs[r]->tryPush(batch)) {
+                cursor = r + 1;
+                if (waiting) {
+                    stats.outputWaitSeconds += secondsSince(waitStart);
+                }
+                return;
+            }
+        }
+        if (!waiting) {
+            waitStart = std::chrono::steady_clock::now();
+            waiting = true;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// Stage kernels, shared by the pipeline and the synchronous loop.
+
+// Parses complete lines of text into batch until it is full; returns the
+// bytes consumed.
+inline size_t parsePipelineBatch(std::string_view text, PipelineBatch& batch)
+{
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    batch.records = 0;
+    batch.invalid.clear();
+    while (batch.records < batch.years.size() && p < end) {
+        int year;
+        int yday;
+        p = parseIsoDateLine<true>(p, end, true, year, yday);
+        if (yday < 0) {
+            batch.invalid.push_back(static_cast<uint32_t>(batch.records));
+            year = 2000;
+            yday = 0;
+        }
+        batch.years[batch.records] = static_cast<int16_t>(year);
+        batch.ydays[batch.records] = static_cast<int16_t>(yday);
+        ++batch.records;
+    }
+    return static_cast<size_t>(p - text.data());
+}
+
+inline void convertPipelineBatch(PipelineBatch& batch) noexcept
+{
+    convertIsoWeekDatesPacked(std::span<const int16_t>(batch.years.data(), batch.records),
+                              std::span<const int16_t>(batch.ydays.data(), batch.records),
+                              std::span<uint32_t>(batch.packed.data(), batch.records));
+    for (uint32_t i : batch.invalid) {
+        batch.packed[i] = 0;
+    }
+}
+
+struct PipelineTally {
+    size_t invalid = 0;
+    size_t outOfRange = 0;
+};
+
+// Counts the batch into histogram slot (isoYear - minIsoYear) * 53 + week - 1.
+inline void aggregatePipelineBatch(const PipelineBatch& batch, std::span<uint64_t> histogram, int minIsoYear,
+                                   PipelineTally& tally) noexcept
+{
+    for (size_t i = 0; i < batch.records; ++i) {
+        const uint32_t packed = batch.packed[i];
+        if (packed == 0) {
+            ++tally.invalid;
+            continue;
+        }
+        const IsoWeekDate d = unpackIsoWeekDate(packed);
+        const size_t slot = static_cast<size_t>(d.isoYear - minIsoYear) * PIPELINE_WEEK_SLOTS + d.week - 1;
+        if (slot < histogram.size()) {
+            ++histogram[slot];
+        } else {
+            ++tally.outOfRange;
+        }
+    }
+}
+
+struct PipelineStageReport {
+    const char* name;
+    size_t threads = 0;
+    size_t queueCapacity = 0;           // Batches per input ring; 0 for parse
+    PipelineThreadStats stats;
+
+    double utilization(double wallSeconds) const
+    {
+        return wallSeconds > 0.0 ? stats.busySeconds / (static_cast<double>(threads) * wallSeconds) : 0.0;
+    }
+    // Records per second the stage could sustain if it never waited.
+    double capacityPerSecond() const
+    {
+        return stats.busySeconds > 0.0 ? static_cast<double>(stats.records) * threads / stats.busySeconds : 0.0;
+    }
+    double queueFillMean() const { return stats.batches ? stats.queueFillSum / stats.batches : 0.0; }
+};
+
+struct PipelineReport {
+    std::vector<PipelineStageReport> stages;    // Parse, convert, aggregate
+    WeekAggregation result;                     // Counts only; seconds is the pipeline's wall time
+    size_t invalid = 0;
+    double syncSeconds = 0.0;                   // The same kernels in one synchronous loop
+};
+
+inline std::vector<IsoWeekGroup> pipelineGroups(std::span<const uint64_t> histogram, int minIsoYear)
+{
+    std::vector<IsoWeekGroup> groups;
+    for (size_t slot = 0; slot < histogram.size(); ++slot) {
+        if (histogram[slot] != 0) {
+            IsoWeekGroup g{makeIsoWeekDate(minIsoYear + static_cast<int>(slot / PIPELINE_WEEK_SLOTS),
+                                           static_cast<int>(slot % PIPELINE_WEEK_SLOTS) + 1, 1), {}};
+            g.aggregate.count = histogram[slot];
+            groups.push_back(g);
+        }
+    }
+    return groups;
+}
+
+// Start of slice k: the first line that starts at or after k * sliceBytes.
+inline size_t pipelineSliceStart(std::string_view text, size_t sliceBytes, size_t k) noexcept
+{
+    const size_t at = k * sliceBytes;
+    if (at == 0 || at >= text.size()) {
+        return std::min(at, text.size());
+    }
+    const void* newline = std::memchr(text.data() + at - 1, '\n', text.size() - at + 1);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - text.data()) + 1 : text.size();
+}
+
+// Runs text through the pipeline with config.pipelineThreads threads per
+// stage, counting weeks of ISO years [minIsoYear, maxIsoYear].
+inline PipelineReport runPipeline(std::string_view text, const BenchmarkConfig& config, int minIsoYear, int maxIsoYear)
+{
+    const size_t parsers = std::max<size_t>(1, config.pipelineThreads[0]);
+    const size_t converters = std::max<size_t>(1, config.pipelineThreads[1]);
+    const size_t aggregators = std::max<size_t>(1, config.pipelineThreads[2]);
+    const size_t batchRecords = std::max<size_t>(1, config.pipelineBatchRecords);
+    const size_t depth = std::max<size_t>(1, config.pipelineQueueDepth);
+    const size_t poolSize = depth * converters + 2;     // Enough to fill every output ring of a parser
+    const size_t histogramSlots = static_cast<size_t>(maxIsoYear - minIsoYear + 1) * PIPELINE_WEEK_SLOTS;
+
+    std::vector<std::unique_ptr<PipelineBatch>> pool;
+    for (size_t p = 0; p < parsers; ++p) {
+        for (size_t k = 0; k < poolSize; ++k) {
+            pool.push_back(std::make_unique<PipelineBatch>(p, batchRecords));
+        }
+    }
+    PipelineLink parsed(parsers, converters, depth);
+    PipelineLink converted(converters, aggregators, depth);
+    PipelineLink recycled(aggregators, parsers, poolSize);
+
+    const size_t sliceBytes = batchRecords * ISO_DATE_LINE_BYTES;
+    const size_t slices = (text.size() + sliceBytes - 1) / sliceBytes;
+    std::atomic<size_t> nextSlice{0};
+
+    std::vector<PipelineThreadStats> parseStats(parsers);
+    std::vector<PipelineThreadStats> convertStats(converters);
+    std::vector<PipelineThreadStats> aggregateStats(aggregators);
+    std::vector<std::vector<uint64_t>> histograms(aggregators);
+    std::vector<PipelineTally> tallies(aggregators);
+
+    auto parseWorker = [&](size_t self) {
+        PipelineThreadStats stats;
+        std::vector<PipelineBatch*> unused;
+        for (size_t k = 0; k < poolSize; ++k) {
+            unused.push_back(pool[self * poolSize + k].get());
+        }
+        const std::vector<PipelineRing*> outputs = parsed.outputsOf(self);
+        const std::vector<PipelineRing*> returned = recycled.inputsOf(self);
+        size_t outCursor = self;
+        size_t returnCursor = 0;
+        for (size_t k; (k = nextSlice.fetch_add(1, std::memory_order_relaxed)) < slices; ) {
+            size_t begin = pipelineSliceStart(text, sliceBytes, k);
+            const size_t end = pipelineSliceStart(text, sliceBytes, k + 1);
+            while (begin < end) {
+                PipelineBatch* batch = nullptr;
+                if (!unused.empty()) {
+                    batch = unused.back();
+                    unused.pop_back();
+                } else {
+                    PipelineThreadStats waited;         // Waiting for a free batch is backpressure, not input
+                    popBatch(returned, returnCursor, batch, waited);
+                    stats.outputWaitSeconds += waited.inputWaitSeconds;
+                }
+                const auto start = std::chrono::steady_clock::now();
+                begin += parsePipelineBatch(text.substr(begin, end - begin), *batch);
+                stats.busySeconds += secondsSince(start);
+                stats.records += batch->records;
+                ++stats.batches;
+                pushBatch(outputs, outCursor, batch, stats);
+            }
+        }
+        for (PipelineRing* ring : outputs) {
+            ring->close();
+        }
+        parseStats[self] = stats;
+    };
+
+    auto convertWorker = [&](size_t self) {
+        PipelineThreadStats stats;
+        const std::vector<PipelineRing*> inputs = parsed.inputsOf(self);
+        const std::vector<PipelineRing*> outputs = converted.outputsOf(self);
+        size_t inCursor = 0;
+        size_t outCursor = self;
+        PipelineBatch* batch;
+        while (popBatch(inputs, inCursor, batch, stats)) {
+            const auto start = std::chrono::steady_clock::now();
+            convertPipelineBatch(*batch);
+            stats.busySeconds += secondsSince(start);
+            stats.records += batch->records;
+            ++stats.batches;
+            pushBatch(outputs, outCursor, batch, stats);
+        }
+        for (PipelineRing* ring : outputs) {
+            ring->close();
+        }
+        convertStats[self] = stats;
+    };
+
+    auto aggregateWorker = [&](size_t self) {
+        PipelineThreadStats stats;
+        PipelineTally tally;
+        std::vector<uint64_t> histogram(histogramSlots);
+        const std::vector<PipelineRing*> inputs = converted.inputsOf(self);
+        size_t inCursor = 0;
+        PipelineBatch* batch;
+        while (popBatch(inputs, inCursor, batch, stats)) {
+            const auto start = std::chrono::steady_clock::now();
+            aggregatePipelineBatch(*batch, histogram, minIsoYear, tally);
+            stats.busySeconds += secondsSince(start);
+            stats.records += batch->records;
+            ++stats.batches;
+            // Never full: the ring holds the owner's whole pool.
+            while (!recycled.at(self, batch->owner).tryPush(batch)) {
+                std::this_thread::yield();
+            }
+        }
+        histograms[self] = std::move(histogram);
+        tallies[self] = tally;
+        aggregateStats[self] = stats;
+    };
+
+    PipelineReport report;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < aggregators; ++t) {
+            threads.emplace_back(aggregateWorker, t);
+        }
+        for (size_t t = 0; t < converters; ++t) {
+            threads.emplace_back(convertWorker, t);
+        }
+        for (size_t t = 0; t < parsers; ++t) {
+            threads.emplace_back(parseWorker, t);
+        }
+    }
+    report.result.seconds = secondsSince(start);
+
+    std::vector<uint64_t>& total = histograms[0];
+    for (size_t t = 1; t < aggregators; ++t) {
+        for (size_t slot = 0; slot < histogramSlots; ++slot) {
+            total[slot] += histograms[t][slot];
+        }
+    }
+    report.result.groups = pipelineGroups(total, minIsoYear);
+    report.result.threads = parsers + converters + aggregators;
+    for (const PipelineTally& tally : tallies) {
+        report.invalid += tally.invalid;
+        report.result.outOfRange += tally.outOfRange;
+    }
+
+    const std::pair<const char*, const std::vector<PipelineThreadStats>*> stages[] = {
+        {"parse", &parseStats}, {"convert", &convertStats}, {"aggregate", &aggregateStats}};
+    for (const auto& [name, perThread] : stages) {
+        PipelineStageReport stage{name, perThread->size(), perThread == &parseStats ? 0 : parsed.at(0, 0).capacity(), {}};
+        for (const PipelineThreadStats& s : *perThread) {
+            stage.stats.add(s);
+        }
+        report.stages.push_back(stage);
+    }
+    report.result.rows = report.stages[0].stats.records;
+    return report;
+}
+
+// The same kernels one batch at a time on the calling thread, for comparison.
+// Returns the invalid and out-of-range counts; the run time goes to seconds.
+inline PipelineTally runPipelineSynchronously(std::string_view text, const BenchmarkConfig& config, int minIsoYear,
+                                              int maxIsoYear, std::vector<uint64_t>& histogram, double& seconds)
+{
+    PipelineBatch batch(0, std::max<size_t>(1, config.pipelineBatchRecords));
+    PipelineTally tally;
+    histogram.assign(static_cast<size_t>(maxIsoYear - minIsoYear + 1) * PIPELINE_WEEK_SLOTS, 0);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t begin = 0; begin < text.size(); ) {
+        begin += parsePipelineBatch(text.substr(begin), batch);
+        convertPipelineBatch(batch);
+        aggregatePipelineBatch(batch, histogram, minIsoYear, tally);
+    }
+    seconds = secondsSince(start);
+    return tally;
+}
+
+inline void printPipelineReport(const PipelineReport& report)
+{
+    const double wall = report.result.seconds;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << std::left << std::setw(11) << "Stage" << std::right << std::setw(8) << "Threads"
+              << std::setw(9) << "Batches" << std::setw(15) << "Capacity M/s" << std::setw(7) << "Busy"
+              << std::setw(9) << "In-wait" << std::setw(10) << "Out-wait" << std::setw(22) << "Input queue fill"
+              << std::endl;
+    const PipelineStageReport* bottleneck = nullptr;
+    for (const PipelineStageReport& s : report.stages) {
+        const double threadSeconds = static_cast<double>(s.threads) * wall;
+        std::cout << "  " << std::left << std::setw(11) << s.name << std::right << std::setw(8) << s.threads
+                  << std::setw(9) << s.stats.batches << std::setw(15) << s.capacityPerSecond() / 1e6
+                  << std::setw(6) << 100.0 * s.utilization(wall) << "%"
+                  << std::setw(8) << (threadSeconds > 0.0 ? 100.0 * s.stats.inputWaitSeconds / threadSeconds : 0.0) << "%"
+                  << std::setw(9) << (threadSeconds > 0.0 ? 100.0 * s.stats.outputWaitSeconds / threadSeconds : 0.0) << "%";
+        if (s.queueCapacity > 0) {
+            std::cout << std::setw(8) << 100.0 * s.queueFillMean() << "% mean " << std::setw(5)
+                      << 100.0 * s.stats.queueFillMax << "% max";
+        }
+        std::cout << std::endl;
+        if (!bottleneck || s.capacityPerSecond() < bottleneck->capacityPerSecond()) {
+            bottleneck = &s;
+        }
+    }
+    std::cout << std::setprecision(2);
+    std::cout << "  Pipeline: " << wall * 1e3 << " ms, " << report.result.rowsPerSecond() / 1e6 << " M records/s"
+              << "; synchronous loop: " << report.syncSeconds * 1e3 << " ms, "
+              << (report.syncSeconds > 0.0 ? report.result.rows / report.syncSeconds / 1e6 : 0.0) << " M records/s"
+              << std::endl;
+    if (bottleneck) {
+        std::cout << "  Bottleneck: " << bottleneck->name << " (" << bottleneck->capacityPerSecond() / 1e6
+                  << " M records/s of capacity)" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+inline void writePipelineMetricsCsv(const PipelineReport& report, const char* path)
+{
+    std::ofstream csv(path);
+    csv << "Stage,Threads,Batches,Records,Wall_s,Busy_s,Input_wait_s,Output_wait_s,Utilization,"
+           "Capacity_records_per_s,Queue_capacity,Queue_fill_mean,Queue_fill_max\n";
+    for (const PipelineStageReport& s : report.stages) {
+        csv << s.name << ","
+            << s.threads << ","
+            << s.stats.batches << ","
+            << s.stats.records << ","
+            << report.result.seconds << ","
+            << s.stats.busySeconds << ","
+            << s.stats.inputWaitSeconds << ","
+            << s.stats.outputWaitSeconds << ","
+            << s.utilization(report.result.seconds) << ","
+            << s.capacityPerSecond() << ","
+            << s.queueCapacity << ","
+            << s.queueFillMean() << ","
+            << s.stats.queueFillMax << "\n";
+    }
+}
+
+// Generates config.pipelineRows "YYYY-MM-DD" lines (generateAggregationColumns
+// days), runs them through the pipeline and the synchronous loop, checks both
+// against aggregateByIsoWeek() on the same days and writes the stage metrics
+// to csvPath. Returns false on a mismatch.
+inline bool runPipelineBenchmark(const BenchmarkConfig& config, const char* csvPath)
+{
+    const int minIsoYear = config.minYear - 1;
+    const int maxIsoYear = config.maxYear + 1;
+    const size_t generatorThreads = std::max(1u, std::thread::hardware_concurrency());
+    const AggregationColumns columns = generateAggregationColumns(config.pipelineRows, config, generatorThreads);
+    std::string text(columns.days.size() * ISO_DATE_LINE_BYTES, '\n');
+    for (size_t i = 0; i < columns.days.size(); ++i) {
+        const YearDay d = civilYearDayFromDays(columns.days[i]);
+        formatIsoDateLine(static_cast<int>(d.year), d.yday, text.data() + i * ISO_DATE_LINE_BYTES);
+    }
+    const WeekAggregation expected = aggregateByIsoWeek(std::span<const int32_t>(columns.days), {},
+                                                        minIsoYear, maxIsoYear, generatorThreads);
+
+    PipelineReport report = runPipeline(text, config, minIsoYear, maxIsoYear);
+    std::vector<uint64_t> histogram;
+    const PipelineTally syncTally = runPipelineSynchronously(text, config, minIsoYear, maxIsoYear, histogram,
+                                                             report.syncSeconds);
+    WeekAggregation synchronous;
+    synchronous.groups = pipelineGroups(histogram, minIsoYear);
+    synchronous.outOfRange = syncTally.outOfRange;
+
+    printPipelineReport(report);
+    const bool pipelineMatches = report.invalid == 0 && sameWeekAggregation(report.result, expected, true);
+    const bool synchronousMatches = syncTally.invalid == 0 && sameWeekAggregation(synchronous, expected, true);
+    std::cout << "  Weeks: " << report.result.groups.size() << ", invalid lines: " << report.invalid
+              << ", out of range: " << report.result.outOfRange << "; pipeline "
+              << (pipelineMatches ? "matches" : "DOES NOT MATCH") << " aggregateByIsoWeek, synchronous loop "
+              << (synchronousMatches ? "matches" : "DOES NOT MATCH") << std::endl;
+    writePipelineMetricsCsv(report, csvPath);
+    return pipelineMatches && synchronousMatches;
+}
+
+// ============================================================================
+// CONVERSION SERVICE (Unix domain socket)
+// ============================================================================
+// --serve PATH answers batched conversion requests on a stream socket from a
+// single-threaded epoll loop. Frames are a 16-byte header and a payload
+// padded to a multiple of 8 bytes, in host (little-endian) byte order:
+//
+//   magic u32 (SERVICE_MAGIC) | op u16 | status u16 | count u32 | id u32
+//
+//   op                   request payload        response payload
+//   DaysToWeeks          int32 epoch days[n]    uint8 weeks[n]
+//   DaysToIsoWeekDates   int32 epoch days[n]    uint32 packed ISO week dates[n]
+//   SecondsToWeeks       int64 Unix seconds[n]  uint8 weeks[n]
+//   Stats                -                      ServiceStatsPayload (count 1)
+//   ResetStats           -                      -
+//
+// Responses echo op and id with status Ok, in request order, so clients may
+// pipeline requests. A bad magic, an unknown op or a count above
+// SERVICE_MAX_RECORDS gets one error response, then the connection closes,
+// since the rest of the stream cannot be framed. Days must lie in
+// [EPOCH_INPUT_MIN_DAYS, EPOCH_INPUT_MAX_DAYS] and seconds in
+// [EPOCH_INPUT_MIN_SECONDS, EPOCH_INPUT_MAX_SECONDS] (0001-01-01 through
+// 9999-12-31); a request with any record outside gets status OutOfRange and
+// no payload, and the connection stays open.
+//
+// Every connection has one input and one output buffer, sized at accept for
+// the largest frames and reused by later connections, so requests are parsed
+// and converted in place without allocation. A request is only converted
+// when its response fits in the output buffer. Otherwise the connection stops
+// reading until the peer has drained its responses (backpressure).
+//
+// Server latency runs from the read() that completed a request to the send()
+// that finished its response, and goes into a LogLinearHistogram (control ops
+// excluded). --load PATH is the matching load generator: --load-connections
+// threads, each with --load-depth requests in flight of --load-batch records,
+// checked against the scalar conversions. With --serve and --load on the same
+// path, the server runs on a thread of the load generator's process.
+#ifdef __linux__
+constexpr uint32_t SERVICE_MAGIC = 0x574F5349;       // "ISOW"
+constexpr size_t SERVICE_HEADER_BYTES = 16;
+constexpr size_t SERVICE_MAX_RECORDS = size_t(1) << 16;
+constexpr size_t SERVICE_MAX_PENDING = 256;           // Responses awaiting send() per connection
+constexpr int SERVICE_EPOLL_EVENTS = 64;
+constexpr size_t SERVICE_LOAD_PAYLOADS = 8;           // Distinct request payloads per load connection
+constexpr int SERVICE_LOAD_TIMEOUT_MS = 10000;
+
+enum class ServiceOp : uint16_t { DaysToWeeks = 1, DaysToIsoWeekDates = 2, SecondsToWeeks = 3, Stats = 16, ResetStats = 17 };
+enum class ServiceStatus : uint16_t { Ok = 0, BadFrame = 1, UnknownOp = 2, TooLarge = 3, OutOfRange = 4 };
+
+struct ServiceFrameHeader {
+    uint32_t magic;
+    uint16_t op;
+    uint16_t status;
+    uint32_t count;
+    uint32_t id;
+};
+static_assert(sizeof(ServiceFrameHeader) == SERVICE_HEADER_BYTES);
+
+struct ServiceStatsPayload {
+    uint64_t requests;
+    uint64_t records;
+    double p50Ns;
+    double p99Ns;
+    double p999Ns;
+    double maxNs;
+};
+
+// Bytes per request record, -1 for an unknown op.
+constexpr int serviceRequestRecordBytes(ServiceOp op) noexcept
+{
+    switch (op) {
+    case ServiceOp::DaysToWeeks:
+    case ServiceOp::DaysToIsoWeekDates: return sizeof(int32_t);
+    case ServiceOp::SecondsToWeeks: return sizeof(int64_t);
+    case ServiceOp::Stats:
+    case ServiceOp::ResetStats: return 0;
+    }
+    return -1;
+}
+
+constexpr size_t serviceResponseRecordBytes(ServiceOp op) noexcept
+{
+    switch (op) {
+    case ServiceOp::DaysToIsoWeekDates: return sizeof(uint32_t);
+    case ServiceOp::Stats: return sizeof(ServiceStatsPayload);
+    case ServiceOp::ResetStats: return 0;
+    default: return sizeof(uint8_t);
+    }
+}
+
+// True when every record of a request lies in the accepted epoch range.
+inline bool serviceRecordsInRange(ServiceOp op, const std::byte* request, size_t n) noexcept
+{
+    bool inRange = true;
+    if (op == ServiceOp::SecondsToWeeks) {
+        const int64_t* seconds = reinterpret_cast<const int64_t*>(request);
+        for (size_t i = 0; i < n; ++i) {
+            inRange &= epochSecondsInRange(seconds[i]);
+        }
+    } else if (op == ServiceOp::DaysToWeeks || op == ServiceOp::DaysToIsoWeekDates) {
+        const int32_t* days = reinterpret_cast<const int32_t*>(request);
+        for (size_t i = 0; i < n; ++i) {
+            inRange &= epochDaysInRange(days[i]);
+        }
+    }
+    return inRange;
+}
+
+constexpr size_t serviceFrameBytes(size_t count, size_t recordBytes) noexcept
+{
+    return SERVICE_HEADER_BYTES + ((count * recordBytes + 7) & ~size_t{7});
+}
+
+constexpr size_t SERVICE_MAX_REQUEST_BYTES = serviceFrameBytes(SERVICE_MAX_RECORDS, sizeof(int64_t));
+constexpr size_t SERVICE_MAX_RESPONSE_BYTES = serviceFrameBytes(SERVICE_MAX_RECORDS, sizeof(uint32_t));
+
+inline std::string serviceError(const char* call, const std::string& path)
+{
+    const int err = errno;
+    return path + ": " + call + " failed (" + std::strerror(err) + ")";
+}
+
+inline sockaddr_un serviceAddress(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+// True when a server accepts connections on the socket at path.
+inline bool serviceSocketInUse(const std::string& path)
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    const sockaddr_un address = serviceAddress(path);
+    const bool connected = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    close(fd);
+    return connected;
+}
+
+class ConversionServer {
+public:
+    ConversionServer() = default;
+    ConversionServer(const ConversionServer&) = delete;
+    ConversionServer& operator=(const ConversionServer&) = delete;
+    ~ConversionServer()
+    {
+        for (auto& c : connections) {
+            if (c->fd >= 0) {
+                close(c->fd);
+            }
+        }
+        for (int fd : {listenFd, stopFd, signalFd, epollFd}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        // Only the socket this server bound, not whatever replaced it since.
+        struct stat current;
+        if (listenFd >= 0 && lstat(socketPath.c_str(), &current) == 0 && S_ISSOCK(current.st_mode)
+            && current.st_dev == socketDevice && current.st_ino == socketInode) {
+            unlink(socketPath.c_str());
+        }
+    }
+
+    // Binds path and sets up the event loop. An existing socket at path is
+    // replaced when no server accepts on it; any other file, or a live
+    // server, is an error.
+    // With handleSignals, SIGINT and SIGTERM are blocked in the calling thread
+    // and end run() through a signalfd. Returns an error message, empty on success.
+    std::string listen(const std::string& path, bool handleSignals)
+    {
+        if constexpr (std::endian::native != std::endian::little) {
+            return "the service framing is little-endian; this host is not";
+        }
+        if (path.size() >= sizeof(sockaddr_un::sun_path)) {
+            return path + ": socket path too long";
+        }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || stopFd < 0) {
+            return serviceError("epoll_create1/eventfd", path);
+        }
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return serviceError("socket", path);
+        }
+        struct stat existing;
+        if (lstat(path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                close(fd);
+                return path + ": exists and is not a socket";
+            }
+            if (serviceSocketInUse(path)) {
+                close(fd);
+                return path + ": another server is listening on this socket";
+            }
+            unlink(path.c_str());
+        }
+        const sockaddr_un address = serviceAddress(path);
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return serviceError("bind", path);
+        }
+        listenFd = fd;
+        socketPath = path;
+        if (lstat(path.c_str(), &existing) == 0) {
+            socketDevice = existing.st_dev;
+            socketInode = existing.st_ino;
+        }
+        if (::listen(listenFd, SOMAXCONN) != 0) {
+            return serviceError("listen", path);
+        }
+        if (handleSignals) {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+            signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (signalFd < 0) {
+                return serviceError("signalfd", path);
+            }
+            watch(signalFd, EPOLLIN, SIGNAL_TOKEN);
+        }
+        watch(listenFd, EPOLLIN, LISTEN_TOKEN);
+        watch(stopFd, EPOLLIN, STOP_TOKEN);
+        return {};
+    }
+
+    // Serves until stop() or a handled signal.
+    void run()
+    {
+        epoll_event events[SERVICE_EPOLL_EVENTS];
+        for (bool running = true; running; ) {
+            const int n = epoll_wait(epollFd, events, SERVICE_EPOLL_EVENTS, -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (int e = 0; e < n; ++e) {
+                const uint64_t token = events[e].data.u64;
+                if (token == LISTEN_TOKEN) {
+                    acceptConnections();
+                } else if (token == STOP_TOKEN || token == SIGNAL_TOKEN) {
+                    running = false;
+                } else {
+                    serve(*connections[token - FIRST_CONNECTION_TOKEN], events[e].events);
+                }
+            }
+        }
+    }
+
+    // Any thread.
+    void stop() noexcept
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(stopFd, &one, sizeof(one));
+    }
+
+    ServiceStatsPayload stats() const
+    {
+        const bool any = latency.count() > 0;
+        return {requests, records, any ? latency.quantile(0.5) : 0.0, any ? latency.quantile(0.99) : 0.0,
+                any ? latency.quantile(0.999) : 0.0, latency.max()};
+    }
+
+private:
+    static constexpr uint64_t LISTEN_TOKEN = 0;
+    static constexpr uint64_t STOP_TOKEN = 1;
+    static constexpr uint64_t SIGNAL_TOKEN = 2;
+    static constexpr uint64_t FIRST_CONNECTION_TOKEN = 3;
+
+    struct PendingResponse {
+        size_t end;                                     // Offset in out just past the response
+        std::chrono::steady_clock::time_point arrived;
+    };
+
+    struct Connection {
+        size_t slot;
+        int fd = -1;
+        uint32_t events = 0;                            // Registered epoll interest
+        bool closing = false;                           // Close once out is flushed
+        bool blocked = false;                           // A complete request waits for room in out
+        std::chrono::steady_clock::time_point arrived;  // Last read()
+        std::vector<std::byte> in;
+        size_t inBegin = 0;
+        size_t inEnd = 0;
+        std::vector<std::byte> out;
+        size_t outBegin = 0;
+        size_t outEnd = 0;
+        std::array<PendingResponse, SERVICE_MAX_PENDING> pending;
+        size_t pendingHead = 0;
+        size_t pendingCount = 0;
+
+        explicit Connection(size_t slotIndex) : slot(slotIndex), in(SERVICE_MAX_REQUEST_BYTES), out(2 * SERVICE_MAX_RESPONSE_BYTES) {}
+    };
+
+    int epollFd = -1;
+    int listenFd = -1;
+    int stopFd = -1;
+    int signalFd = -1;
+    std::string socketPath;
+    dev_t socketDevice = 0;             // Identity of the bound socket file
+    ino_t socketInode = 0;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<size_t> freeSlots;
+    LogLinearHistogram latency;
+    uint64_t requests = 0;
+    uint64_t records = 0;
+
+    void watch(int fd, uint32_t events, uint64_t token)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = token;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void acceptConnections()
+    {
+        for (;;) {
+            const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;                 // EAGAIN, or an error the next event retries
+            }
+            if (freeSlots.empty()) {
+                freeSlots.push_back(connections.size());
+                connections.push_back(std::make_unique<Connection>(connections.size()));
+            }
+            Connection& c = *connections[freeSlots.back()];
+            freeSlots.pop_back();
+            c.fd = fd;
+            c.events = EPOLLIN | EPOLLRDHUP;
+            c.closing = c.blocked = false;
+            c.inBegin = c.inEnd = c.outBegin = c.outEnd = 0;
+            c.pendingHead = c.pendingCount = 0;
+            watch(fd, c.events, FIRST_CONNECTION_TOKEN + c.slot);
+        }
+    }
+
+    void disconnect(Connection& c)
+    {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        close(c.fd);
+        c.fd = -1;
+        freeSlots.push_back(c.slot);
+    }
+
+    void serve(Connection& c, uint32_t events)
+    {
+        bool ok = true;
+        if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !c.closing && !c.blocked) {
+            ok = readRequests(c);
+        }
+        for (int pass = 0; ok && pass < 2; ++pass) {      // Again once flushing made room
+            processRequests(c);
+            ok = flushResponses(c);
+        }
+        if (!ok || (c.closing && c.outBegin == c.outEnd)) {
+            disconnect(c);
+            return;
+        }
+        const uint32_t wanted = (c.closing || c.blocked ? 0u : EPOLLIN | EPOLLRDHUP)
+                              | (c.outBegin < c.outEnd ? EPOLLOUT : 0u);
+        if (wanted != c.events) {
+            epoll_event ev{};
+            ev.events = wanted;
+            ev.data.u64 = FIRST_CONNECTION_TOKEN + c.slot;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+            c.events = wanted;
+        }
+    }
+
+    // One recv() into the input buffer. Returns false on a socket error.
+    bool readRequests(Connection& c)
+    {
+        if (c.inBegin > 0) {                            // Frames are 8-byte multiples, so offset 0 keeps alignment
+            std::memmove(c.in.data(), c.in.data() + c.inBegin, c.inEnd - c.inBegin);
+            c.inEnd -= c.inBegin;
+            c.inBegin = 0;
+        }
+        for (;;) {
+            const ssize_t n = recv(c.fd, c.in.data() + c.inEnd, c.in.size() - c.inEnd, 0);
+            if (n > 0) {
+                c.inEnd += static_cast<size_t>(n);
+                c.arrived = std::chrono::steady_clock::now();
+                return true;
+            }
+            if (n == 0) {
+                c.closing = true;                       // Answer what arrived, then close
+                return true;
+            }
+            if (errno != EINTR) {
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
+    }
+
+    // Converts the complete requests in the input buffer whose responses fit
+    // in the output buffer.
+    void processRequests(Connection& c)
+    {
+        c.blocked = false;
+        while (c.inEnd - c.inBegin >= SERVICE_HEADER_BYTES) {
+            ServiceFrameHeader header;
+            std::memcpy(&header, c.in.data() + c.inBegin, sizeof(header));
+            const ServiceOp op = static_cast<ServiceOp>(header.op);
+            const int requestRecordBytes = serviceRequestRecordBytes(op);
+            const ServiceStatus status = header.magic != SERVICE_MAGIC ? ServiceStatus::BadFrame
+                                       : requestRecordBytes < 0 ? ServiceStatus::UnknownOp
+                                       : header.count > SERVICE_MAX_RECORDS ? ServiceStatus::TooLarge
+                                       : ServiceStatus::Ok;
+            if (status != ServiceStatus::Ok) {
+                if (!reserveOutput(c, SERVICE_HEADER_BYTES)) {
+                    c.blocked = true;
+                    return;
+                }
+                header = {SERVICE_MAGIC, header.op, static_cast<uint16_t>(status), 0, header.id};
+                std::memcpy(c.out.data() + c.outEnd, &header, sizeof(header));
+                c.outEnd += SERVICE_HEADER_BYTES;
+                c.closing = true;
+                c.inBegin = c.inEnd = 0;
+                return;
+            }
+            const size_t requestBytes = serviceFrameBytes(header.count, static_cast<size_t>(requestRecordBytes));
+            if (c.inEnd - c.inBegin < requestBytes) {
+                break;
+            }
+            const uint32_t responseCount = op == ServiceOp::Stats ? 1 : op == ServiceOp::ResetStats ? 0 : header.count;
+            const size_t responseBytes = serviceFrameBytes(responseCount, serviceResponseRecordBytes(op));
+            if (!reserveOutput(c, responseBytes)) {
+                c.blocked = true;
+                return;
+            }
+
+            const std::byte* request = c.in.data() + c.inBegin + SERVICE_HEADER_BYTES;
+            std::byte* response = c.out.data() + c.outEnd + SERVICE_HEADER_BYTES;
+            const size_t n = header.count;
+            if (!serviceRecordsInRange(op, request, n)) {
+                header.status = static_cast<uint16_t>(ServiceStatus::OutOfRange);
+                header.count = 0;
+                std::memcpy(c.out.data() + c.outEnd, &header, sizeof(header));
+                c.outEnd += SERVICE_HEADER_BYTES;
+                c.inBegin += requestBytes;
+                continue;
+            }
+            switch (op) {
+            case ServiceOp::DaysToWeeks:
+                convertEpochDaysToWeeks(std::span<const int32_t>(reinterpret_cast<const int32_t*>(request), n),
+                                        std::span<uint8_t>(reinterpret_cast<uint8_t*>(response), n));
+                break;
+            case ServiceOp::DaysToIsoWeekDates: {
+                const int32_t* days = reinterpret_cast<const int32_t*>(request);
+                uint32_t* packed = reinterpret_cast<uint32_t*>(response);
+                for (size_t i = 0; i < n; ++i) {
+                    packed[i] = packIsoWeekDate(convertEpochDaysToIsoWeekDate(days[i]));
+                }
+                break;
+            }
+            case ServiceOp::SecondsToWeeks:
+                convertEpochSecondsToWeeks(std::span<const int64_t>(reinterpret_cast<const int64_t*>(request), n),
+                                           std::span<uint8_t>(reinterpret_cast<uint8_t*>(response), n));
+                break;
+            case ServiceOp::Stats: {
+                const ServiceStatsPayload payload = stats();
+                std::memcpy(response, &payload, sizeof(payload));
+                break;
+            }
+            case ServiceOp::ResetStats:
+                latency = LogLinearHistogram();
+                requests = records = 0;
+                break;
+            }
+            // The output buffer is reused, so clear the padding of earlier responses.
+            const size_t payloadBytes = responseCount * serviceResponseRecordBytes(op);
+            std::memset(response + payloadBytes, 0, responseBytes - SERVICE_HEADER_BYTES - payloadBytes);
+            header.status = static_cast<uint16_t>(ServiceStatus::Ok);
+            header.count = responseCount;
+            std::memcpy(c.out.data() + c.outEnd, &header, sizeof(header));
+            c.outEnd += responseBytes;
+            c.inBegin += requestBytes;
+            if (op != ServiceOp::Stats && op != ServiceOp::ResetStats) {
+                c.pending[(c.pendingHead + c.pendingCount++) % SERVICE_MAX_PENDING] = {c.outEnd, c.arrived};
+                ++requests;
+                records += n;
+            }
+        }
+        if (c.inBegin == c.inEnd) {
+            c.inBegin = c.inEnd = 0;
+        }
+    }
+
+    bool reserveOutput(Connection& c, size_t bytes)
+    {
+        if (c.outBegin == c.outEnd) {
+            c.outBegin = c.outEnd = 0;                  // Everything sent, so nothing is pending either
+        }
+        return c.pendingCount < SERVICE_MAX_PENDING && c.out.size() - c.outEnd >= bytes;
+    }
+
+    // send()s as much of the output buffer as the socket takes and records
+    // the latency of every response that went out completely. Returns false
+    // on a socket error.
+    bool flushResponses(Connection& c)
+    {
+        bool ok = true;
+        while (c.outBegin < c.outEnd) {
+            const ssize_t n = send(c.fd, c.out.data() + c.outBegin, c.outEnd - c.outBegin, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = errno == EAGAIN || errno == EWOULDBLOCK;
+                break;
+            }
+            c.outBegin += static_cast<size_t>(n);
+        }
+        if (c.pendingCount > 0 && c.pending[c.pendingHead].end <= c.outBegin) {
+            const auto now = std::chrono::steady_clock::now();
+            while (c.pendingCount > 0 && c.pending[c.pendingHead].end <= c.outBegin) {
+                latency.add(std::chrono::duration<double, std::nano>(now - c.pending[c.pendingHead].arrived).count());
+                c.pendingHead = (c.pendingHead + 1) % SERVICE_MAX_PENDING;
+                --c.pendingCount;
+            }
+        }
+        return ok;
+    }
+};
+
+// Connects to the service; returns the blocking socket, or -1 with error set.
+inline int connectService(const std::string& path, std::string& error)
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const sockaddr_un address = serviceAddress(path);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        error = serviceError("connect", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+inline bool sendAll(int fd, const void* data, size_t bytes)
+{
+    for (const char* p = static_cast<const char*>(data); bytes > 0; ) {
+        const ssize_t n = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool receiveAll(int fd, void* data, size_t bytes)
+{
+    for (char* p = static_cast<char*>(data); bytes > 0; ) {
+        const ssize_t n = recv(fd, p, bytes, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// One control request (Stats or ResetStats) on a blocking socket.
+inline bool serviceControl(int fd, ServiceOp op, ServiceStatsPayload* stats)
+{
+    ServiceFrameHeader header{SERVICE_MAGIC, static_cast<uint16_t>(op), 0, 0, 0};
+    if (!sendAll(fd, &header, sizeof(header)) || !receiveAll(fd, &header, sizeof(header))
+        || header.status != static_cast<uint16_t>(ServiceStatus::Ok)) {
+        return false;
+    }
+    alignas(8) std::byte payload[serviceFrameBytes(1, sizeof(ServiceStatsPayload)) - SERVICE_HEADER_BYTES];
+    const size_t bytes = serviceFrameBytes(header.count, serviceResponseRecordBytes(op)) - SERVICE_HEADER_BYTES;
+    if (bytes > sizeof(payload) || !receiveAll(fd, payload, bytes)) {
+        return false;
+    }
+    if (stats && bytes >= sizeof(ServiceStatsPayload)) {
+        std::memcpy(stats, payload, sizeof(ServiceStatsPayload));
+    }
+    return true;
+}
+
+inline ServiceOp serviceOpFor(BenchmarkConfig::ServiceRequest request)
+{
+    switch (request) {
+    case BenchmarkConfig::ServiceRequest::DaysToIsoWeekDates: return ServiceOp::DaysToIsoWeekDates;
+    case BenchmarkConfig::ServiceRequest::SecondsToWeeks: return ServiceOp::SecondsToWeeks;
+    default: return ServiceOp::DaysToWeeks;
+    }
+}
+
+inline const char* serviceRequestName(BenchmarkConfig::ServiceRequest request)
+{
+    switch (request) {
+    case BenchmarkConfig::ServiceRequest::DaysToIsoWeekDates: return "iso";
+    case BenchmarkConfig::ServiceRequest::SecondsToWeeks: return "seconds";
+    default: return "days";
+    }
+}
+
+constexpr BenchmarkConfig::ServiceRequest ALL_SERVICE_REQUESTS[] = {
+    BenchmarkConfig::ServiceRequest::DaysToWeeks,
+    BenchmarkConfig::ServiceRequest::DaysToIsoWeekDates,
+    BenchmarkConfig::ServiceRequest::SecondsToWeeks,
+};
+
+struct ServiceLoadReport {
+    std::string error;                  // Empty on success
+    size_t requests = 0;
+    size_t records = 0;
+    size_t mismatches = 0;              // Responses that differ from the scalar conversion
+    double seconds = 0.0;
+    LogLinearHistogram roundTrip;       // Client side, first byte sent to last byte received
+    ServiceStatsPayload server{};
+};
+
+struct ServiceLoadFrame {
+    std::vector<std::byte> request;
+    std::vector<std::byte> expected;    // Response payload
+};
+
+// Request frames of batch random dates of [minYear, maxYear] with their
+// expected responses from the scalar conversions.
+inline std::vector<ServiceLoadFrame> buildServiceLoadFrames(ServiceOp op, size_t batch, const BenchmarkConfig& config,
+                                                            size_t connection)
+{
+    std::seed_seq seed{GENERATOR_SEED, static_cast<uint32_t>(connection)};
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int64_t> dayDist(daysFromYearDay(config.minYear, 0), daysFromYearDay(config.maxYear + 1, 0) - 1);
+    std::uniform_int_distribution<int64_t> secondDist(0, 86399);
+    const size_t requestRecord = static_cast<size_t>(serviceRequestRecordBytes(op));
+    const size_t responseRecord = serviceResponseRecordBytes(op);
+
+    std::vector<ServiceLoadFrame> frames(SERVICE_LOAD_PAYLOADS);
+    for (ServiceLoadFrame& frame : frames) {
+        frame.request.assign(serviceFrameBytes(batch, requestRecord), std::byte{0});
+        frame.expected.assign(serviceFrameBytes(batch, responseRecord) - SERVICE_HEADER_BYTES, std::byte{0});
+        const ServiceFrameHeader header{SERVICE_MAGIC, static_cast<uint16_t>(op), 0, static_cast<uint32_t>(batch), 0};
+        std::memcpy(frame.request.data(), &header, sizeof(header));
+        std::byte* payload = frame.request.data() + SERVICE_HEADER_BYTES;
+        for (size_t i = 0; i < batch; ++i) {
+            const int64_t day = dayDist(gen);
+            if (op == ServiceOp::SecondsToWeeks) {
+                const int64_t seconds = day * 86400 + secondDist(gen);
+                std::memcpy(payload + i * sizeof(int64_t), &seconds, sizeof(seconds));
+                frame.expected[i] = static_cast<std::byte>(convertEpochSecondsToWeek(seconds));
+            } else {
+                const int32_t days = static_cast<int32_t>(day);
+                std::memcpy(payload + i * sizeof(int32_t), &days, sizeof(days));
+                if (op == ServiceOp::DaysToIsoWeekDates) {
+                    const uint32_t packed = packIsoWeekDate(convertEpochDaysToIsoWeekDate(day));
+                    std::memcpy(frame.expected.data() + i * sizeof(uint32_t), &packed, sizeof(packed));
+                } else {
+                    frame.expected[i] = static_cast<std::byte>(convertEpochDaysToWeek(day));
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+struct ServiceLoadThread {
+    std::string error;
+    size_t mismatches = 0;
+    LogLinearHistogram roundTrip;
+};
+
+// One load connection: keeps depth requests in flight on a non-blocking
+// socket until requests responses have arrived.
+inline void runServiceLoadConnection(int fd, std::vector<ServiceLoadFrame>& frames, size_t requests, size_t depth,
+                                     ServiceLoadThread& out)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    std::vector<std::chrono::steady_clock::time_point> sentAt(depth);
+    std::vector<std::byte> buffer(frames[0].expected.size() + SERVICE_HEADER_BYTES);
+    size_t filled = 0;
+    size_t sent = 0;
+    size_t sendOffset = 0;
+    size_t received = 0;
+    while (received < requests) {
+        bool progress = false;
+        while (sent < requests && sent - received < depth) {
+            std::vector<std::byte>& request = frames[sent % frames.size()].request;
+            if (sendOffset == 0) {
+                const uint32_t id = static_cast<uint32_t>(sent);
+                std::memcpy(request.data() + offsetof(ServiceFrameHeader, id), &id, sizeof(id));
+                sentAt[sent % depth] = std::chrono::steady_clock::now();
+            }
+            const ssize_t n = send(fd, request.data() + sendOffset, request.size() - sendOffset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    break;
+                }
+                out.error = std::string("send failed (") + std::strerror(errno) + ")";
+                return;
+            }
+            progress = true;
+            sendOffset += static_cast<size_t>(n);
+            if (sendOffset == request.size()) {
+                sendOffset = 0;
+                ++sent;
+            }
+        }
+
+        const ssize_t n = recv(fd, buffer.data() + filled, buffer.size() - filled, 0);
+        if (n == 0) {
+            out.error = "server closed the connection";
+            return;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            out.error = std::string("recv failed (") + std::strerror(errno) + ")";
+            return;
+        }
+        if (n > 0) {
+            progress = true;
+            filled += static_cast<size_t>(n);
+            if (filled == buffer.size()) {
+                const auto now = std::chrono::steady_clock::now();
+                ServiceFrameHeader header;
+                std::memcpy(&header, buffer.data(), sizeof(header));
+                if (header.status != static_cast<uint16_t>(ServiceStatus::Ok) || header.id != received) {
+                    out.error = "unexpected response (status " + std::to_string(header.status) + ", id "
+                              + std::to_string(header.id) + ")";
+                    return;
+                }
+                const std::vector<std::byte>& expected = frames[received % frames.size()].expected;
+                out.mismatches += std::memcmp(buffer.data() + SERVICE_HEADER_BYTES, expected.data(), expected.size()) != 0;
+                out.roundTrip.add(std::chrono::duration<double, std::nano>(now - sentAt[received % depth]).count());
+                ++received;
+                filled = 0;
+            }
+        }
+
+        if (!progress) {
+            pollfd p{fd, static_cast<short>(POLLIN | (sent < requests && sent - received < depth ? POLLOUT : 0)), 0};
+            if (poll(&p, 1, SERVICE_LOAD_TIMEOUT_MS) == 0) {
+                out.error = "timed out waiting for the server";
+                return;
+            }
+        }
+    }
+}
+
+// Runs config.loadConnections connections of config.loadRequests requests
+// of one request type against the service at path; the server's statistics
+// are reset first and read back at the end.
+inline ServiceLoadReport runServiceLoad(const std::string& path, BenchmarkConfig::ServiceRequest request,
+                                        const BenchmarkConfig& config)
+{
+    ServiceLoadReport report;
+    const ServiceOp op = serviceOpFor(request);
+    const size_t connections = std::max<size_t>(1, config.loadConnections);
+    const size_t batch = std::clamp<size_t>(config.loadBatchRecords, 1, SERVICE_MAX_RECORDS);
+    const size_t depth = std::max<size_t>(1, config.loadDepth);
+
+    const int control = connectService(path, report.error);
+    if (control < 0) {
+        return report;
+    }
+    if (!serviceControl(control, ServiceOp::ResetStats, nullptr)) {
+        report.error = path + ": ResetStats failed";
+        close(control);
+        return report;
+    }
+
+    std::vector<int> fds;
+    std::vector<std::vector<ServiceLoadFrame>> frames;
+    for (size_t c = 0; c < connections && report.error.empty(); ++c) {
+        const int fd = connectService(path, report.error);
+        if (fd >= 0) {
+            fds.push_back(fd);
+            frames.push_back(buildServiceLoadFrames(op, batch, config, c));
+        }
+    }
+    std::vector<ServiceLoadThread> threads(fds.size());
+    if (report.error.empty()) {
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> pool;
+            for (size_t c = 0; c < fds.size(); ++c) {
+                pool.emplace_back([&, c] { runServiceLoadConnection(fds[c], frames[c], config.loadRequests, depth, threads[c]); });
+            }
+        }
+        report.seconds = secondsSince(start);
+    }
+    for (int fd : fds) {
+        close(fd);
+    }
+    for (const ServiceLoadThread& t : threads) {
+        if (report.error.empty() && !t.error.empty()) {
+            report.error = t.error;
+        }
+        report.mismatches += t.mismatches;
+        report.roundTrip.merge(t.roundTrip);
+    }
+    report.requests = report.roundTrip.count();
+    report.records = report.requests * batch;
+    if (report.error.empty() && !serviceControl(control, ServiceOp::Stats, &report.server)) {
+        report.error = path + ": Stats failed";
+    }
+    close(control);
+    return report;
+}
+
+inline void printServiceLatency(const char* label, double p50, double p99, double p999, double max)
+{
+    std::cout << "  " << std::left << std::setw(20) << label << std::right << "p50 " << std::setw(9) << p50 / 1e3
+              << "  p99 " << std::setw(9) << p99 / 1e3 << "  p999 " << std::setw(9) << p999 / 1e3
+              << "  max " << std::setw(9) << max / 1e3 << " us" << std::endl;
+}
+
+inline void printServiceLoadReport(const ServiceLoadReport& report)
+{
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Requests: " << report.requests << " (" << report.records << " records) in "
+              << report.seconds * 1e3 << " ms: "
+              << (report.seconds > 0.0 ? report.requests / report.seconds / 1e3 : 0.0) << " K requests/s, "
+              << (report.seconds > 0.0 ? report.records / report.seconds / 1e6 : 0.0) << " M records/s" << std::endl;
+    const LogLinearHistogram& rt = report.roundTrip;
+    if (rt.count() > 0) {
+        printServiceLatency("Round trip (client)", rt.quantile(0.5), rt.quantile(0.99), rt.quantile(0.999), rt.max());
+    }
+    printServiceLatency("Server", report.server.p50Ns, report.server.p99Ns, report.server.p999Ns, report.server.maxNs);
+    std::cout << "  Server counted " << report.server.requests << " requests, " << report.server.records
+              << " records; mismatches: " << report.mismatches << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+#endif
+
+// ============================================================================
+// VARIANT REGISTRY
+// ============================================================================
+// Every benchmarked kernel registers itself with REGISTER_VARIANT. main() runs
+// the registry in registration order, filtered by --only/--exclude, and skips
+// variants whose ISA the CPU lacks; --verify-exhaustive checks the same list.
+// Adding a kernel means writing it and adding one registration line.
+
+enum class VariantKind { Scalar, Batch };
+enum class VariantIsa { None, SSE2, AVX2, AVX512F, AVX512BW };
+
+// What a variant reads. Decides when the struct tm column can be released and
+// when the epoch columns and the date text have to be built.
+enum class VariantInput { TimeStruct, YearDay, EpochDays, EpochSeconds, Text, WeekDate };
 
-    if (config.verboseOutput) {
-        std::cout << "  Testing " << name << "..." << std::flush;
+struct BenchmarkContext {
+    TestCorpus& testData;
+    const BenchmarkConfig& config;
+    std::vector<int32_t> epochDays;         // Built before the first epoch variant runs
+    std::vector<int64_t> epochSeconds;
+    std::string dateText;                   // "YYYY-MM-DD\n" per element, built before the first text variant
+    std::vector<uint32_t> isoWeekDates;     // Packed ISO week dates, built before the first reverse variant
+};
+
+struct VariantInfo {
+    std::string name;
+    VariantKind kind;
+    VariantIsa isa;
+    VariantInput input;
+    bool fullResult;                        // ISO year + week + weekday rather than the week only
+    const char* weekOnlyPeer;               // Week-only counterpart for the overhead table, or nullptr
+    BenchmarkResult (*run)(const VariantInfo&, BenchmarkContext&);
+    void (*verify)(VerifyBlock&, std::span<IsoWeekDate>);   // nullptr: skipped by --verify-exhaustive
+    const void* code = nullptr;             // Kernel entry point, for the code size column
+    int minYear = 1;                        // Years the variant is defined for; it is skipped
+    int maxYear = 32767;                    // unless they cover the benchmark or verify range
+};
+
+inline std::vector<VariantInfo>& variantRegistry() {
+    static std::vector<VariantInfo> registry;
+    return registry;
+}
+
+struct VariantRegistrar {
+    explicit VariantRegistrar(VariantInfo info) { variantRegistry().push_back(std::move(info)); }
+};
+
+#define ISO_WEEK_CONCAT_IMPL(a, b) a##b
+#define ISO_WEEK_CONCAT(a, b) ISO_WEEK_CONCAT_IMPL(a, b)
+#define REGISTER_VARIANT(...) \
+    static const VariantRegistrar ISO_WEEK_CONCAT(variantRegistrar_, __COUNTER__)(__VA_ARGS__)
+
+inline const char* variantKindName(VariantKind kind) {
+    return kind == VariantKind::Batch ? "batch" : "scalar";
+}
+
+inline const char* variantIsaName(VariantIsa isa) {
+    switch (isa) {
+    case VariantIsa::SSE2: return "SSE2";
+    case VariantIsa::AVX2: return "AVX2";
+    case VariantIsa::AVX512F: return "AVX512F";
+    case VariantIsa::AVX512BW: return "AVX512BW";
+    default: return "none";
     }
+}
 
-    // Capture memory (before)
-    if (config.trackMemory) {
-        result.memoryBefore.capture();
+inline bool variantIsaSupported(VariantIsa isa) {
+#ifdef ISO_WEEK_X86_SIMD
+    const CpuFeatures& cpu = CpuFeatures::get();
+    switch (isa) {
+    case VariantIsa::SSE2: return cpu.sse2;
+    case VariantIsa::AVX2: return cpu.avx2;
+    case VariantIsa::AVX512F: return cpu.avx512f;
+    case VariantIsa::AVX512BW: return cpu.avx512f && cpu.avx512bw;
+    default: return true;
     }
+#else
+    return isa == VariantIsa::None;
+#endif
+}
 
-    // Warm-up
-    for (size_t i = 0; i < 10000; ++i) {
-        volatile int week = func(testData[i % testData.size()].timeStruct);
-        (void)week;
+// Glob match where '*' stands for any run of characters.
+inline bool globMatch(std::string_view pattern, std::string_view name) {
+    size_t p = 0, n = 0, star = std::string_view::npos, resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            ++p;
+            ++n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
     }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
 
-    // Benchmark
-    std::vector<double> times;
-    times.reserve(config.iterationCount);
+// patterns is a comma-separated list of globs.
+inline bool matchesAnyPattern(std::string_view patterns, std::string_view name) {
+    while (!patterns.empty()) {
+        const size_t comma = patterns.find(',');
+        if (globMatch(patterns.substr(0, comma), name)) {
+            return true;
+        }
+        patterns = comma == std::string_view::npos ? std::string_view() : patterns.substr(comma + 1);
+    }
+    return false;
+}
 
-#ifdef _WIN32
-    // ===============================================================
-    // WINDOWS VERSION (Batching due to low timer resolution)
-    // ===============================================================
-    const int BATCH_SIZE = 1000;
-    size_t testDataIndex = 0;
+inline bool variantSelected(const VariantInfo& variant, const BenchmarkConfig& config) {
+    return (config.onlyVariants.empty() || matchesAnyPattern(config.onlyVariants, variant.name))
+        && !matchesAnyPattern(config.excludeVariants, variant.name);
+}
 
-    for (size_t i = 0; i < config.iterationCount; ++i) {
-        auto start = std::chrono::high_resolution_clock::now();
+// Per-call kernels on the corpus' struct tm column.
+template<auto Func>
+VariantInfo timeStructVariant(const char* name, const char* weekOnlyPeer = nullptr) {
+    using R = std::invoke_result_t<decltype(Func), const struct tm&>;
+    return {name, VariantKind::Scalar, VariantIsa::None, VariantInput::TimeStruct,
+            std::is_same_v<R, IsoWeekDate>, weekOnlyPeer,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                return benchmarkFunction(v.name, Func, c.testData, c.config);
+            },
+            verifyPerCall<Func>, reinterpret_cast<const void*>(Func)};
+}
 
-        for(int j = 0; j < BATCH_SIZE; ++j) {
-            const auto& testCase = testData[testDataIndex];
-            volatile int week = func(testCase.timeStruct);
-            (void)week;
+// Batch kernels on the year/yday columns.
+template<auto Kernel>
+VariantInfo batchVariant(const char* name, VariantIsa isa = VariantIsa::None, const char* weekOnlyPeer = nullptr) {
+    using OutT = typename std::tuple_element_t<2, typename FunctionArgs<decltype(Kernel)>::type>::element_type;
+    return {name, VariantKind::Batch, isa, VariantInput::YearDay, !std::is_same_v<OutT, uint8_t>, weekOnlyPeer,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                return benchmarkBatchFunction(v.name, BatchFunc<OutT>(Kernel), c.testData, c.config);
+            },
+            verifyBatch<Kernel>, reinterpret_cast<const void*>(Kernel)};
+}
+
+// Per-call kernels on epoch days (Seconds = false) or Unix seconds.
+template<auto Func, bool Seconds>
+VariantInfo epochVariant(const char* name, const char* weekOnlyPeer = nullptr) {
+    using R = std::invoke_result_t<decltype(Func), int64_t>;
+    return {name, VariantKind::Scalar, VariantIsa::None, Seconds ? VariantInput::EpochSeconds : VariantInput::EpochDays,
+            std::is_same_v<R, IsoWeekDate>, weekOnlyPeer,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                if constexpr (Seconds) {
+                    return benchmarkInputFunction(v.name, Func, [&c](size_t i) { return c.epochSeconds[i]; },
+                                                  c.testData, c.config);
+                } else {
+                    return benchmarkInputFunction(v.name, Func, [&c](size_t i) { return static_cast<int64_t>(c.epochDays[i]); },
+                                                  c.testData, c.config);
+                }
+            },
+            verifyEpochPerCall<Func, Seconds>, reinterpret_cast<const void*>(Func)};
+}
+
+// Batch kernels on the epoch day or epoch second column.
+template<auto Kernel>
+VariantInfo epochBatchVariant(const char* name, VariantIsa isa = VariantIsa::None) {
+    using InT = std::remove_const_t<typename std::tuple_element_t<0, typename FunctionArgs<decltype(Kernel)>::type>::element_type>;
+    constexpr bool seconds = std::is_same_v<InT, int64_t>;
+    return {name, VariantKind::Batch, isa, seconds ? VariantInput::EpochSeconds : VariantInput::EpochDays, false, nullptr,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                if constexpr (seconds) {
+                    return benchmarkColumnBatchFunction(v.name, EpochBatchFunc<InT>(Kernel), c.epochSeconds, c.testData, c.config);
+                } else {
+                    return benchmarkColumnBatchFunction(v.name, EpochBatchFunc<InT>(Kernel), c.epochDays, c.testData, c.config);
+                }
+            },
+            verifyEpochBatch<Kernel>, reinterpret_cast<const void*>(Kernel)};
+}
+
+// For entry points that only forward to a kernel function: the code size
+// column reports the kernel, not the few bytes of the forwarding call.
+inline VariantInfo withKernelCode(VariantInfo info, const void* kernel) {
+    info.code = kernel;
+    return info;
+}
+
+// Per-call V4 specialized for years [MinYear, MaxYear] (see YearRange).
+template<int MinYear, int MaxYear>
+VariantInfo rangeVariant(const char* name) {
+    VariantInfo info = timeStructVariant<convertGregorianDateToWeekDate_Range<MinYear, MaxYear>>(name);
+    info.minYear = MinYear;
+    info.maxYear = MaxYear;
+    return info;
+}
+
+// Text parsers on the corpus formatted as fixed-width date lines.
+template<auto Kernel>
+VariantInfo textVariant(const char* name, VariantIsa isa = VariantIsa::None) {
+    return {name, VariantKind::Batch, isa, VariantInput::Text, false, nullptr,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                return benchmarkTextFunction(v.name, Kernel, c.dateText, c.testData, c.config);
+            },
+            verifyText<Kernel>, reinterpret_cast<const void*>(Kernel)};
+}
+
+// Per-call reverse kernels on the corpus' packed ISO week dates.
+template<auto Func>
+VariantInfo reverseVariant(const char* name) {
+    return {name, VariantKind::Scalar, VariantIsa::None, VariantInput::WeekDate, true, nullptr,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                return benchmarkInputFunction(v.name, Func, [&c](size_t i) { return unpackIsoWeekDate(c.isoWeekDates[i]); },
+                                              c.testData, c.config);
+            },
+            verifyReverse<Func>, reinterpret_cast<const void*>(Func)};
+}
+
+// Batch reverse kernels on the same column.
+template<auto Kernel>
+VariantInfo reverseBatchVariant(const char* name, VariantIsa isa = VariantIsa::None) {
+    return {name, VariantKind::Batch, isa, VariantInput::WeekDate, true, nullptr,
+            [](const VariantInfo& v, BenchmarkContext& c) {
+                return benchmarkReverseBatchFunction<Kernel>(v.name, c.isoWeekDates, c.testData, c.config);
+            },
+            verifyReverseBatch<Kernel>, reinterpret_cast<const void*>(Kernel)};
+}
+
+#ifndef _WIN32
+// Baseline for the reverse kernels: let timegm() find Jan 4's weekday, then
+// normalize Monday of week 1 plus the offset into a year and yday.
+YearDay convertIsoWeekDateToYearDay_timegm(IsoWeekDate d) noexcept
+{
+    struct tm t;
+    std::memset(&t, 0, sizeof(t));
+    t.tm_year = d.isoYear - 1900;
+    t.tm_mday = 4;
+    t.tm_hour = 12;
+    timegm(&t);
+    t.tm_mday = 4 - (t.tm_wday + 6) % 7 + 7 * (d.week - 1) + (d.weekday - 1);
+    timegm(&t);
+    return {t.tm_year + 1900, t.tm_yday};
+}
+#endif
+
+#ifndef _WIN32
+// Baseline for the epoch entry points: libc breakdown, then Original.
+int convertEpochSecondsToWeek_gmtime(int64_t seconds) noexcept
+{
+    const time_t t = static_cast<time_t>(seconds);
+    struct tm utc;
+    gmtime_r(&t, &utc);
+    return convertGregorianDateToWeekDate_Original(utc);
+}
+#endif
+
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_Original>("Original"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V1>("V1_EarlyReturn"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V2>("V2_BitOps_"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V3>("V3_Precalculation"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V4>("V4_MathMask"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V5>("V5_YearTable"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToWeekDate_V6>("V6_MulShift"));
+REGISTER_VARIANT(rangeVariant<1, 9999>("V4_Range1_9999"));
+REGISTER_VARIANT(rangeVariant<1901, 2099>("V4_Range1901_2099"));
+
+REGISTER_VARIANT(batchVariant<convertWeekDates_Scalar>("Batch_Scalar"));
+#ifdef ISO_WEEK_X86_SIMD
+REGISTER_VARIANT(withKernelCode(batchVariant<convertWeekDates_SSE2>("Batch_SSE2", VariantIsa::SSE2),
+                                 reinterpret_cast<const void*>(weekKernel_SSE2)));
+REGISTER_VARIANT(withKernelCode(batchVariant<convertWeekDates_AVX2>("Batch_AVX2", VariantIsa::AVX2),
+                                 reinterpret_cast<const void*>(weekKernel_AVX2)));
+REGISTER_VARIANT(withKernelCode(batchVariant<convertWeekDates_AVX512>("Batch_AVX512", VariantIsa::AVX512BW),
+                                 reinterpret_cast<const void*>(weekKernel_AVX512)));
+#endif
+REGISTER_VARIANT(batchVariant<convertWeekDates_Table>("Batch_V5Table"));
+
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_Original>("Original_Full", "Original"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_V1>("V1_Full", "V1_EarlyReturn"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_V2>("V2_Full", "V2_BitOps_"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_V3>("V3_Full", "V3_Precalculation"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_V4>("V4_Full", "V4_MathMask"));
+REGISTER_VARIANT(timeStructVariant<convertGregorianDateToIsoWeekDate_V5>("V5_Full", "V5_YearTable"));
+REGISTER_VARIANT(batchVariant<convertIsoWeekDates>("BatchFull_V5Table", VariantIsa::None, "Batch_V5Table"));
+REGISTER_VARIANT(batchVariant<convertIsoWeekDatesPacked>("BatchPacked_V5Table", VariantIsa::None, "Batch_V5Table"));
+REGISTER_VARIANT(batchVariant<convertSortedWeeks>("BatchSortedWeeks_Cursor"));
+REGISTER_VARIANT(batchVariant<convertSorted>("BatchSorted_Cursor", VariantIsa::None, "BatchSortedWeeks_Cursor"));
+
+#ifndef _WIN32
+REGISTER_VARIANT(epochVariant<convertEpochSecondsToWeek_gmtime, true>("Epoch_gmtime_r+Original"));
+#endif
+REGISTER_VARIANT(epochVariant<convertEpochSecondsToWeek, true>("Epoch_Seconds"));
+REGISTER_VARIANT(epochVariant<convertEpochDaysToWeek, false>("Epoch_Days"));
+REGISTER_VARIANT(epochVariant<convertEpochDaysToIsoWeekDate, false>("Epoch_Days_Full", "Epoch_Days"));
+REGISTER_VARIANT(epochBatchVariant<convertEpochDaysToWeeks_Scalar>("EpochDaysBatch_Scalar"));
+#ifdef ISO_WEEK_X86_SIMD
+REGISTER_VARIANT(withKernelCode(epochBatchVariant<convertEpochDaysToWeeks_AVX2>("EpochDaysBatch_AVX2", VariantIsa::AVX2),
+                                 reinterpret_cast<const void*>(epochDaysKernel_AVX2)));
+REGISTER_VARIANT(withKernelCode(epochBatchVariant<convertEpochDaysToWeeks_AVX512>("EpochDaysBatch_AVX512", VariantIsa::AVX512F),
+                                 reinterpret_cast<const void*>(epochDaysKernel_AVX512)));
+#endif
+REGISTER_VARIANT(epochBatchVariant<convertEpochSecondsToWeeks>("EpochSecondsBatch"));
+REGISTER_VARIANT(epochBatchVariant<convertSortedEpochDaysToWeeks>("EpochDaysSorted_Cursor"));
+
+#ifndef _WIN32
+REGISTER_VARIANT(textVariant<convertIsoDateText_strptime>("Text_strptime+Original"));
+#endif
+REGISTER_VARIANT(withKernelCode(textVariant<convertIsoDateText_Scalar>("Text_Scalar"),
+                                 reinterpret_cast<const void*>(convertIsoDateTextImpl<false>)));
+#ifdef ISO_WEEK_X86_SIMD
+REGISTER_VARIANT(withKernelCode(textVariant<convertIsoDateText>("Text_SSE2", VariantIsa::SSE2),
+                                 reinterpret_cast<const void*>(convertIsoDateTextImpl<true>)));
+#endif
 
-            testDataIndex++;
-            if (testDataIndex >= testData.size()) {
-                testDataIndex = 0;
+#ifndef _WIN32
+REGISTER_VARIANT(reverseVariant<convertIsoWeekDateToYearDay_timegm>("Reverse_timegm"));
+#endif
+REGISTER_VARIANT(reverseVariant<convertIsoWeekDateToYearDay_Scalar>("Reverse_Scalar"));
+REGISTER_VARIANT(reverseVariant<convertIsoWeekDateToYearDay_Branchless>("Reverse_Branchless"));
+REGISTER_VARIANT(reverseVariant<convertIsoWeekDateToEpochDays>("Reverse_EpochDays"));
+REGISTER_VARIANT(reverseBatchVariant<convertIsoWeekDatesToYearDays>("ReverseBatch_YearDays"));
+REGISTER_VARIANT(reverseBatchVariant<convertIsoWeekDatesToEpochDays_Scalar>("ReverseBatch_Scalar"));
+#ifdef ISO_WEEK_X86_SIMD
+REGISTER_VARIANT(withKernelCode(reverseBatchVariant<convertIsoWeekDatesToEpochDays_AVX2>("ReverseBatch_AVX2", VariantIsa::AVX2),
+                                 reinterpret_cast<const void*>(reverseEpochKernel_AVX2)));
+REGISTER_VARIANT(withKernelCode(reverseBatchVariant<convertIsoWeekDatesToEpochDays_AVX512>("ReverseBatch_AVX512", VariantIsa::AVX512F),
+                                 reinterpret_cast<const void*>(reverseEpochKernel_AVX512)));
+#endif
+
+// Runs the selected variants on one corpus, config.trialCount times. A single
+// trial runs them in registry order; with several, each trial uses a fresh
+// random order, and each variant's trials are combined by combineTrials. The
+// struct tm column is dropped after the last trial's last variant that reads
+// it. The epoch and week-date columns are built before the first variant
+// that reads them, and the epoch and reverse paths are verified the first
+// time that happens in the process.
+std::vector<BenchmarkResult> runVariants(const std::vector<const VariantInfo*>& selected, TestCorpus& testData,
+                                         const BenchmarkConfig& config, bool& epochVerified, bool& reverseVerified) {
+    const size_t trialCount = std::max<size_t>(1, config.trialCount);
+    std::mt19937_64 orderRng(config.trialSeed);
+    std::vector<size_t> order(selected.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+
+    BenchmarkContext context{testData, config, {}, {}, {}, {}};
+    bool epochColumnsReady = false;
+    std::vector<std::vector<BenchmarkResult>> trials(selected.size());
+    for (size_t trial = 0; trial < trialCount; ++trial) {
+        if (trialCount > 1) {
+            std::shuffle(order.begin(), order.end(), orderRng);
+            std::cout << "  Trial " << trial + 1 << "/" << trialCount << std::endl;
+        }
+
+        size_t releaseAfter = 0;
+        if (trial + 1 == trialCount) {
+            for (size_t pos = 0; pos < order.size(); ++pos) {
+                if (selected[order[pos]]->input == VariantInput::TimeStruct) {
+                    releaseAfter = pos + 1;
+                }
+            }
+            if (releaseAfter == 0) {
+                testData.releaseTimeStructs();
             }
         }
 
-        auto end = std::chrono::high_resolution_clock::now();
-        double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count() / BATCH_SIZE;
-        times.push_back(elapsed_ns);
-    }
-#else
-    // ===============================================================
-    // LINUX VERSION
-    // ===============================================================
-    for (size_t i = 0; i < config.iterationCount; ++i) {
-        const auto& testCase = testData[i % testData.size()];
+        const double trialMHz = CpuFrequencyInfo::readCurrentMHz();
+        for (size_t pos = 0; pos < order.size(); ++pos) {
+            const VariantInfo& variant = *selected[order[pos]];
+            const bool epochInput = variant.input == VariantInput::EpochDays || variant.input == VariantInput::EpochSeconds;
+            if (epochInput && !epochColumnsReady) {
+                if (!epochVerified) {
+                    // Epoch-based entry points: inputs are the same dates as Unix seconds and day numbers.
+                    std::cout << "  Verifying epoch conversions against gmtime_r/Original (" << config.minYear << "-" << config.maxYear << ")..." << std::flush;
+                    const size_t epochMismatches = verifyEpochConversions(config.minYear, config.maxYear, config.verboseOutput);
+                    std::cout << (epochMismatches == 0 ? " PASS" : " FAIL") << " (" << epochMismatches << " mismatches)" << std::endl;
+                    epochVerified = true;
+                }
 
-        auto start = std::chrono::high_resolution_clock::now();
-        volatile int week = func(testCase.timeStruct);
-        auto end = std::chrono::high_resolution_clock::now();
+                context.epochSeconds.resize(testData.size());
+                context.epochDays.resize(testData.size());
+                for (size_t i = 0; i < testData.size(); ++i) {
+                    const int64_t day = daysFromYearDay(testData.years[i], testData.ydays[i]);
+                    context.epochDays[i] = static_cast<int32_t>(day);
+                    context.epochSeconds[i] = day * 86400 + static_cast<int64_t>((i * 2654435761u) % 86400);
+                }
+                epochColumnsReady = true;
+            }
 
-        double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
-        times.push_back(elapsed_ns);
-        (void)week;
+            if (variant.input == VariantInput::Text && context.dateText.empty()) {
+                context.dateText.resize(testData.size() * ISO_DATE_LINE_BYTES);
+                for (size_t i = 0; i < testData.size(); ++i) {
+                    formatIsoDateLine(testData.years[i], testData.ydays[i], context.dateText.data() + i * ISO_DATE_LINE_BYTES);
+                }
+            }
+
+            if (variant.input == VariantInput::WeekDate && context.isoWeekDates.empty()) {
+                if (!reverseVerified) {
+                    std::cout << "  Verifying reverse conversions by round trip through Original (" << config.minYear << "-"
+                              << config.maxYear << ")..." << std::flush;
+                    const size_t reverseMismatches = verifyReverseConversions(config.minYear, config.maxYear, config.verboseOutput);
+                    std::cout << (reverseMismatches == 0 ? " PASS" : " FAIL") << " (" << reverseMismatches << " mismatches)" << std::endl;
+                    reverseVerified = true;
+                }
+
+                context.isoWeekDates.resize(testData.size());
+                for (size_t i = 0; i < testData.size(); ++i) {
+                    context.isoWeekDates[i] = packIsoWeekDate(
+                        convertGregorianDateToIsoWeekDate_Original(timeStructFor(testData.years[i], testData.ydays[i])));
+                }
+            }
+
+            BenchmarkResult result = variant.run(variant, context);
+            result.codeBytes = CodeSizeTable::bytesAt(variant.code);
+            result.trials.minMHz = result.trials.maxMHz = trialMHz;
+            trials[order[pos]].push_back(std::move(result));
+
+            if (pos + 1 == releaseAfter) {
+                testData.releaseTimeStructs();
+            }
+        }
     }
-#endif
 
-    // Capture memory (after)
-    if (config.trackMemory) {
-        result.memoryAfter.capture();
+    std::vector<BenchmarkResult> results;
+    results.reserve(selected.size());
+    for (auto& variantTrials : trials) {
+        results.push_back(combineTrials(variantTrials, config));
     }
+    return results;
+}
+
+// ============================================================================
+// BASELINE COMPARISON (--compare)
+// ============================================================================
+// A single trial has the zero-width interval [median, median], which would
+// turn every 1 ns of noise into a significant change. Both sides of a
+// comparison need at least this many trials.
+constexpr size_t COMPARE_MIN_TRIALS = 3;
 
-    // Statistics
-    std::sort(times.begin(), times.end());
+struct BaselineEntry {
+    std::string version;
+    std::string distribution;
+    double medianNs = 0.0;
+    ConfidenceInterval median;
+    size_t trials = 1;                  // 1 when the file has no Trials column
+};
 
-    double sum = 0.0;
-    for (double t : times) {
-        sum += t;
+// Reads the Version, Distribution, Median_ns, Trials and median interval
+// columns of a benchmark_analysis.csv. Rows from fewer than
+// COMPARE_MIN_TRIALS trials are an error. Returns an error message, or an
+// empty string on success.
+inline std::string loadBaseline(const std::string& path, std::vector<BaselineEntry>& entries) {
+    std::ifstream file(path);
+    if (!file) {
+        return "Cannot open baseline " + path;
     }
+    auto split = [](const std::string& line) {
+        std::vector<std::string> fields;
+        std::istringstream in(line);
+        std::string field;
+        while (std::getline(in, field, ',')) {
+            fields.push_back(field);
+        }
+        return fields;
+    };
 
-    result.averageTimeNs = sum / times.size();
-    result.minTimeNs = times.front();
-    result.maxTimeNs = times.back();
-    result.medianTimeNs = times[times.size() / 2];
-    result.percentile95Ns = times[static_cast<size_t>(times.size() * 0.95)];
-    result.percentile99Ns = times[static_cast<size_t>(times.size() * 0.99)];
+    std::string line;
+    std::getline(file, line);
+    const std::vector<std::string> header = split(line);
+    auto column = [&header](const char* name) {
+        const auto it = std::find(header.begin(), header.end(), name);
+        return it == header.end() ? -1 : static_cast<int>(it - header.begin());
+    };
+    const int version = column("Version");
+    const int distribution = column("Distribution");
+    const int median = column("Median_ns");
+    const int low = column("Median_CI_low_ns");
+    const int high = column("Median_CI_high_ns");
+    const int trials = column("Trials");
+    if (version < 0 || median < 0) {
+        return path + " has no Version/Median_ns columns";
+    }
 
-    // Correctness check
-    result.correctnessCheck = true;
-    for (const auto& testCase : testData) {
-        int res1 = convertGregorianDateToWeekDate_Original(testCase.timeStruct);
-        int res2 = func(testCase.timeStruct);
-        if (res1 != res2) {
-            result.correctnessCheck = false;
-            result.discrepancies++;
-            if (config.verboseOutput && result.discrepancies <= 5) {
-                std::cout << "\n    DISCREPANCY: " << testCase.description
-                          << " Year=" << testCase.year
-                          << " Day=" << testCase.dayOfYear
-                          << " Original=" << res1
-                          << " " << name << "=" << res2;
-            }
+    while (std::getline(file, line)) {
+        const std::vector<std::string> fields = split(line);
+        if (static_cast<int>(fields.size()) <= std::max({version, distribution, median})) {
+            continue;
+        }
+        BaselineEntry entry;
+        entry.version = fields[version];
+        entry.distribution = distribution >= 0 ? fields[distribution] : "uniform";
+        entry.medianNs = std::strtod(fields[median].c_str(), nullptr);
+        entry.median = {entry.medianNs, entry.medianNs};
+        if (low >= 0 && high >= 0 && static_cast<int>(fields.size()) > std::max(low, high)
+            && !fields[low].empty() && !fields[high].empty()) {
+            entry.median = {std::strtod(fields[low].c_str(), nullptr), std::strtod(fields[high].c_str(), nullptr)};
+        }
+        if (trials >= 0 && static_cast<int>(fields.size()) > trials) {
+            entry.trials = std::strtoull(fields[trials].c_str(), nullptr, 10);
         }
+        if (entry.trials < COMPARE_MIN_TRIALS) {
+            return path + ": " + entry.version + " comes from " + std::to_string(entry.trials)
+                   + " trial(s); rerun the baseline with --trials " + std::to_string(COMPARE_MIN_TRIALS) + " or more";
+        }
+        entries.push_back(std::move(entry));
     }
+    return entries.empty() ? path + " has no result rows" : std::string();
+}
 
-    if (config.verboseOutput) {
-        std::cout << " Done!" << std::endl;
-    }
+// Prints one line per result that the baseline also has and returns the
+// number of regressions: the median interval lies entirely above the
+// baseline's and the median is more than config.regressionThreshold slower.
+inline size_t compareWithBaseline(const std::vector<BaselineEntry>& baseline, const char* distribution,
+                                  const std::vector<BenchmarkResult>& results, const BenchmarkConfig& config) {
+    size_t regressions = 0;
+    for (const BenchmarkResult& r : results) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&](const BaselineEntry& b) {
+            return b.version == r.versionName && b.distribution == distribution;
+        });
+        if (it == baseline.end()) {
+            std::cout << "  " << std::left << std::setw(26) << r.versionName << std::right << "not in baseline" << std::endl;
+            continue;
+        }
+        const double change = r.medianTimeNs / it->medianNs - 1.0;
+        const bool slower = r.trials.median.low > it->median.high && change > config.regressionThreshold;
+        const bool faster = r.trials.median.high < it->median.low && change < -config.regressionThreshold;
+        regressions += slower;
 
-    return result;
+        std::cout << "  " << std::left << std::setw(26) << r.versionName << std::right
+                  << it->medianNs << " [" << it->median.low << ", " << it->median.high << "] -> "
+                  << r.medianTimeNs << " [" << r.trials.median.low << ", " << r.trials.median.high << "] ns  "
+                  << std::showpos << 100.0 * change << std::noshowpos << "%  "
+                  << (slower ? "REGRESSION" : faster ? "faster" : "no significant change") << std::endl;
+    }
+    return regressions;
 }
 
 int main(int argc, char* argv[]) {
@@ -465,6 +7646,169 @@ int main(int argc, char* argv[]) {
             config.includeEdgeCases = false;
         } else if (arg == "--quiet") {
             config.verboseOutput = false;
+        } else if (arg.rfind("--timing=", 0) == 0) {
+            const std::string mode = arg.substr(9);
+            if (mode == "per-call") {
+                config.timingMode = BenchmarkConfig::TimingMode::PerCall;
+            } else if (mode == "batch") {
+                config.timingMode = BenchmarkConfig::TimingMode::Batch;
+            } else if (mode == "rdtsc") {
+                config.timingMode = BenchmarkConfig::TimingMode::Rdtsc;
+            } else {
+                std::cerr << "Unknown timing mode: " << mode << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--stats=", 0) == 0) {
+            const std::string backend = arg.substr(8);
+            if (backend == "auto") {
+                config.statsBackend = BenchmarkConfig::StatsBackend::Auto;
+            } else if (backend == "exact") {
+                config.statsBackend = BenchmarkConfig::StatsBackend::Exact;
+            } else if (backend == "histogram") {
+                config.statsBackend = BenchmarkConfig::StatsBackend::Histogram;
+            } else {
+                std::cerr << "Unknown statistics backend: " << backend << std::endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threadCount = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--only" && i + 1 < argc) {
+            config.onlyVariants = argv[++i];
+        } else if (arg == "--exclude" && i + 1 < argc) {
+            config.excludeVariants = argv[++i];
+        } else if (arg == "--distribution" && i + 1 < argc) {
+            config.distributions.clear();
+            std::string_view list = argv[++i];
+            while (!list.empty()) {
+                const size_t comma = list.find(',');
+                const std::string_view name = list.substr(0, comma);
+                bool known = false;
+                for (const auto d : ALL_DISTRIBUTIONS) {
+                    if (name == "all" || name == distributionName(d)) {
+                        config.distributions.push_back(d);
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    std::cerr << "Unknown distribution: " << name << std::endl;
+                    return 1;
+                }
+                list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+            }
+        } else if (arg == "--no-perf") {
+            config.perfCounters = false;
+        } else if (arg == "--list-variants") {
+            for (const VariantInfo& v : variantRegistry()) {
+                std::cout << std::left << std::setw(26) << v.name << std::setw(8) << variantKindName(v.kind)
+                          << std::setw(10) << variantIsaName(v.isa)
+                          << (variantIsaSupported(v.isa) ? "" : "unsupported on this CPU");
+                if (v.minYear != 1 || v.maxYear != 32767) {
+                    std::cout << "years " << v.minYear << "-" << v.maxYear;
+                }
+                std::cout << std::right << "\n";
+            }
+            return 0;
+        } else if (arg == "--verify-exhaustive") {
+            config.verifyExhaustive = true;
+        } else if (arg == "--verify-years" && i + 2 < argc) {
+            config.verifyExhaustive = true;
+            config.verifyMinYear = std::stoi(argv[++i]);
+            config.verifyMaxYear = std::stoi(argv[++i]);
+        } else if (arg == "--gen-threads" && i + 1 < argc) {
+            config.generatorThreads = std::stoull(argv[++i]);
+        } else if (arg == "--generate-file" && i + 2 < argc) {
+            config.generateFilePath = argv[++i];
+            config.generateFileRecords = std::stoull(argv[++i]);
+        } else if (arg == "--convert-file" && i + 2 < argc) {
+            config.convertInputPath = argv[++i];
+            config.convertOutputPath = argv[++i];
+        } else if (arg == "--file-format" && i + 1 < argc) {
+            const std::string format = argv[++i];
+            if (format == "days") {
+                config.fileFormat = BenchmarkConfig::FileFormat::EpochDays;
+            } else if (format == "seconds") {
+                config.fileFormat = BenchmarkConfig::FileFormat::EpochSeconds;
+            } else {
+                std::cerr << "Unknown file format: " << format << std::endl;
+                return 1;
+            }
+        } else if (arg == "--timing-batch" && i + 1 < argc) {
+            config.timingBatchSize = std::stoull(argv[++i]);
+        } else if (arg == "--tail-threshold" && i + 1 < argc) {
+            config.tailThresholdNs = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--tail-window" && i + 1 < argc) {
+            config.tailWindowSamples = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--sweep-working-set") {
+            config.sweepWorkingSet = true;
+        } else if (arg == "--sweep-max-mb" && i + 1 < argc) {
+            config.sweepWorkingSet = true;
+            config.sweepMaxBytes = std::max<size_t>(1, std::stoull(argv[++i])) << 20;
+        } else if (arg == "--aggregate" && i + 1 < argc) {
+            config.aggregateRows = std::stoull(argv[++i]);
+        } else if (arg == "--aggregate-file" && i + 1 < argc) {
+            config.aggregateInputPath = argv[++i];
+        } else if (arg == "--pipeline" && i + 1 < argc) {
+            config.pipelineRows = std::stoull(argv[++i]);
+        } else if (arg == "--pipeline-threads" && i + 1 < argc) {
+            const std::string list = argv[++i];
+            size_t stages = 0;
+            std::istringstream in(list);
+            for (std::string count; std::getline(in, count, ',') && stages < config.pipelineThreads.size(); ) {
+                config.pipelineThreads[stages++] = std::max<size_t>(1, std::stoull(count));
+            }
+            if (stages != config.pipelineThreads.size()) {
+                std::cerr << "--pipeline-threads takes PARSE,CONVERT,AGGREGATE thread counts: " << list << std::endl;
+                return 1;
+            }
+        } else if (arg == "--pipeline-batch" && i + 1 < argc) {
+            config.pipelineBatchRecords = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--pipeline-queue" && i + 1 < argc) {
+            config.pipelineQueueDepth = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--serve" && i + 1 < argc) {
+            config.servePath = argv[++i];
+        } else if (arg == "--load" && i + 1 < argc) {
+            config.loadPath = argv[++i];
+        } else if (arg == "--load-op" && i + 1 < argc) {
+            config.loadOps.clear();
+            std::string_view list = argv[++i];
+            while (!list.empty()) {
+                const size_t comma = list.find(',');
+                const std::string_view name = list.substr(0, comma);
+                bool known = false;
+                for (const auto op : ALL_SERVICE_REQUESTS) {
+                    if (name == "all" || name == serviceRequestName(op)) {
+                        config.loadOps.push_back(op);
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    std::cerr << "Unknown load op: " << name << std::endl;
+                    return 1;
+                }
+                list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+            }
+        } else if (arg == "--load-connections" && i + 1 < argc) {
+            config.loadConnections = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--load-requests" && i + 1 < argc) {
+            config.loadRequests = std::stoull(argv[++i]);
+        } else if (arg == "--load-batch" && i + 1 < argc) {
+            config.loadBatchRecords = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--load-depth" && i + 1 < argc) {
+            config.loadDepth = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--trials" && i + 1 < argc) {
+            config.trialCount = std::max<size_t>(1, std::stoull(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.trialSeed = std::stoull(argv[++i]);
+        } else if (arg == "--confidence" && i + 1 < argc) {
+            config.confidenceLevel = std::stod(argv[++i]);
+            if (!(config.confidenceLevel > 0.5 && config.confidenceLevel < 1.0)) {
+                std::cerr << "Confidence level must be between 0.5 and 1 (e.g. 0.95)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--compare" && i + 1 < argc) {
+            config.compareBaselinePath = argv[++i];
+        } else if (arg == "--regression-threshold" && i + 1 < argc) {
+            config.regressionThreshold = std::stod(argv[++i]) / 100.0;
         } else if (arg == "--help") {
             std::cout << "Usage: " << argv[0] << " [options]\n"
                       << "Options:\n"
@@ -474,29 +7818,382 @@ int main(int argc, char* argv[]) {
                       << "  --year-max YEAR     Maximum year (default: 3000)\n"
                       << "  --no-edge-cases     Disable boundary cases\n"
                       << "  --quiet             Minimal output\n"
+                      << "  --timing=MODE       per-call | batch | rdtsc (default: " << timingModeName(config.timingMode) << ")\n"
+                      << "  --timing-batch N    Calls per sample in batch mode (default: " << config.timingBatchSize << ")\n"
+                      << "  --tail-threshold NS Record samples above NS with the faults, context switches and migrations\n"
+                      << "                      of their window, attribute each one (tail_timeline.csv)\n"
+                      << "  --tail-window N     Samples per attribution window (default: " << config.tailWindowSamples << ")\n"
+                      << "  --threads N         Worker threads per benchmark, pinned one per CPU (default: 1)\n"
+                      << "  --only LIST         Run only variants matching these comma-separated globs (e.g. 'Batch_*,V4*')\n"
+                      << "  --exclude LIST      Skip variants matching these comma-separated globs\n"
+                      << "  --distribution LIST uniform | sorted | recent | boundary | alternating, comma-separated, or all\n"
+                      << "                      (default: uniform)\n"
+                      << "  --no-perf           Do not read hardware performance counters\n"
+                      << "  --list-variants     List registered variants with kind and ISA, then exit\n"
+                      << "  --verify-exhaustive Check every (year, yday) of years " << config.verifyMinYear << "-"
+                      << config.verifyMaxYear << " for every variant and exit\n"
+                      << "  --verify-years A B  Range for --verify-exhaustive (" << VERIFY_MIN_YEAR << "-" << VERIFY_MAX_YEAR << ")\n"
+                      << "  --gen-threads N     Test data generator threads (default: all hardware threads)\n"
+                      << "  --generate-file PATH N  Write N random records (--file-format, --year-min/max) and exit\n"
+                      << "  --convert-file IN OUT   Convert a column file to one week byte per record via mmap and exit;\n"
+                      << "                      records outside 0001-01-01..9999-12-31 become week 0 and fail the run\n"
+                      << "  --file-format FMT   days (int32 epoch days) | seconds (int64 Unix seconds), little-endian\n"
+                      << "                      (default: days)\n"
+                      << "  --sweep-working-set Time V4 and the batch kernel on working sets from 4 KB up, AoS vs SoA, and exit\n"
+                      << "  --sweep-max-mb N    Largest working set of the sweep in MB (default: "
+                      << (config.sweepMaxBytes >> 20) << ", capped at half the physical memory)\n"
+                      << "  --aggregate N       Group N generated rows by ISO week (count/sum/min/max), dense per-thread\n"
+                      << "                      histograms vs convert + unordered_map, in rows/s, and exit\n"
+                      << "  --aggregate-file PATH Count the rows of a column file (--file-format) per ISO week into\n"
+                      << "                      week_aggregates.csv and exit\n"
+                      << "  --pipeline N        Run N generated text dates through parse -> convert -> aggregate stages\n"
+                      << "                      connected by SPSC rings, report per-stage metrics and exit\n"
+                      << "  --pipeline-threads P,C,A  Threads of the parse, convert and aggregate stages (default: 1,1,1)\n"
+                      << "  --pipeline-batch N  Records per batch (default: " << config.pipelineBatchRecords << ")\n"
+                      << "  --pipeline-queue N  Batches per ring, rounded up to a power of two (default: "
+                      << config.pipelineQueueDepth << ")\n"
+                      << "  --serve PATH        Serve batched conversions on a Unix domain socket until SIGINT/SIGTERM\n"
+                      << "  --load PATH         Load-test the service at PATH and exit; with --serve on the same path the\n"
+                      << "                      server runs in this process\n"
+                      << "  --load-op LIST      days (days -> weeks) | iso (days -> ISO week dates) | seconds, comma-separated\n"
+                      << "                      or all, run back to back on one server (default: days)\n"
+                      << "  --load-connections N  Client connections, one thread each (default: " << config.loadConnections << ")\n"
+                      << "  --load-requests N   Requests per connection (default: " << config.loadRequests << ")\n"
+                      << "  --load-batch N      Records per request, at most " << (size_t(1) << 16) << " (default: "
+                      << config.loadBatchRecords << ")\n"
+                      << "  --load-depth N      Requests in flight per connection (default: " << config.loadDepth << ")\n"
+                      << "  --trials N          Independent trials per variant in random order, with outlier rejection\n"
+                      << "                      and bootstrap confidence intervals (default: 1)\n"
+                      << "  --seed N            Seed for the trial order and the bootstrap (default: " << config.trialSeed << ")\n"
+                      << "  --confidence X      Confidence level of the intervals (default: " << config.confidenceLevel << ")\n"
+                      << "  --compare CSV       Compare medians with an earlier benchmark_analysis.csv; exit 1 on regression\n"
+                      << "                      (both runs need --trials " << COMPARE_MIN_TRIALS << " or more)\n"
+                      << "  --regression-threshold PCT  Smallest median slowdown counted as a regression (default: "
+                      << 100.0 * config.regressionThreshold << ")\n"
+                      << "  --stats=BACKEND     auto | exact | histogram (auto: histogram above "
+                      << config.autoHistogramSamples << " samples)\n"
                       << "  --help              Show this help\n";
             return 0;
         }
     }
 
+    if (!config.generateFilePath.empty() || !config.convertInputPath.empty()) {
+        const size_t threads = config.threadCount > 1 ? config.threadCount
+                                                      : std::max(1u, std::thread::hardware_concurrency());
+        if (!config.generateFilePath.empty()) {
+            std::cout << "Generating " << config.generateFilePath << ": " << config.generateFileRecords << " "
+                      << fileFormatName(config.fileFormat) << " records, years " << config.minYear << "-"
+                      << config.maxYear << std::endl;
+            const std::string error = generateColumnFile(config.generateFilePath, config.generateFileRecords,
+                                                         config.fileFormat, config.minYear, config.maxYear, threads);
+            if (!error.empty()) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        if (!config.convertInputPath.empty()) {
+            std::cout << "Converting " << config.convertInputPath << " -> " << config.convertOutputPath << std::endl;
+            const FileConversionReport report = convertColumnFile(config.convertInputPath, config.convertOutputPath,
+                                                                  config.fileFormat, threads);
+            if (!report.error.empty()) {
+                std::cerr << report.error << std::endl;
+                return 1;
+            }
+            printFileConversionReport(report, config.fileFormat);
+            return report.mismatches == 0 && report.outOfRange == 0 ? 0 : 1;
+        }
+        return 0;
+    }
+
+    if (!config.servePath.empty() || !config.loadPath.empty()) {
+#ifdef __linux__
+        ConversionServer server;
+        if (config.loadPath.empty()) {
+            if (const std::string error = server.listen(config.servePath, true); !error.empty()) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            std::cout << "Serving on " << config.servePath << " (SIGINT/SIGTERM to stop)" << std::endl;
+            server.run();
+            const ServiceStatsPayload stats = server.stats();
+            std::cout << "Served " << stats.requests << " requests, " << stats.records << " records" << std::endl;
+            std::cout << std::fixed << std::setprecision(2);
+            printServiceLatency("Server", stats.p50Ns, stats.p99Ns, stats.p999Ns, stats.maxNs);
+            std::cout.unsetf(std::ios::floatfield);
+            return 0;
+        }
+        if (!config.servePath.empty() && config.servePath != config.loadPath) {
+            std::cerr << "--serve and --load run together only on the same path" << std::endl;
+            return 1;
+        }
+        std::jthread serverThread;
+        if (!config.servePath.empty()) {
+            if (const std::string error = server.listen(config.servePath, false); !error.empty()) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            serverThread = std::jthread([&server] { server.run(); });
+        }
+        bool passed = true;
+        for (const auto op : config.loadOps) {
+            std::cout << "=== SERVICE LOAD (" << config.loadPath << (serverThread.joinable() ? ", in-process server" : "")
+                      << ", " << serviceRequestName(op) << ", " << config.loadConnections << " connections x "
+                      << config.loadRequests << " requests of " << config.loadBatchRecords << " records, depth "
+                      << config.loadDepth << ") ===" << std::endl;
+            const ServiceLoadReport report = runServiceLoad(config.loadPath, op, config);
+            if (!report.error.empty()) {
+                std::cerr << report.error << std::endl;
+                passed = false;
+                break;
+            }
+            printServiceLoadReport(report);
+            passed = passed && report.mismatches == 0;
+        }
+        if (serverThread.joinable()) {
+            server.stop();
+            serverThread.join();
+        }
+        return passed ? 0 : 1;
+#else
+        std::cerr << "--serve and --load need Unix domain sockets and epoll (Linux only)" << std::endl;
+        return 1;
+#endif
+    }
+
+    if (config.pipelineRows > 0) {
+        std::cout << "=== PIPELINE (" << config.pipelineRows << " lines, years " << config.minYear << "-"
+                  << config.maxYear << ", threads parse/convert/aggregate " << config.pipelineThreads[0] << "/"
+                  << config.pipelineThreads[1] << "/" << config.pipelineThreads[2] << ", batch "
+                  << config.pipelineBatchRecords << ", queue " << std::bit_ceil(config.pipelineQueueDepth)
+                  << ") ===" << std::endl;
+        const bool matches = runPipelineBenchmark(config, "pipeline_metrics.csv");
+        std::cout << "Wrote pipeline_metrics.csv" << std::endl;
+        return matches ? 0 : 1;
+    }
+
+    if (config.aggregateRows > 0 || !config.aggregateInputPath.empty()) {
+        const size_t threads = config.threadCount > 1 ? config.threadCount
+                                                      : std::max(1u, std::thread::hardware_concurrency());
+        if (!config.aggregateInputPath.empty()) {
+            std::cout << "Aggregating " << config.aggregateInputPath << " by ISO week (ISO years "
+                      << config.minYear - 1 << "-" << config.maxYear + 1 << ")" << std::endl;
+            const std::string error = aggregateColumnFile(config.aggregateInputPath, config.fileFormat, config,
+                                                          threads, "week_aggregates.csv");
+            if (!error.empty()) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            std::cout << "Wrote week_aggregates.csv" << std::endl;
+            return 0;
+        }
+        bool allMatch = true;
+        for (const BenchmarkConfig::Distribution distribution : config.distributions) {
+            config.distribution = distribution;
+            std::cout << "=== GROUP BY ISO WEEK (" << config.aggregateRows << " rows, years " << config.minYear << "-"
+                      << config.maxYear << ", " << distributionName(distribution) << ") ===" << std::endl;
+            if (distribution == BenchmarkConfig::Distribution::Boundary
+                || distribution == BenchmarkConfig::Distribution::Alternating) {
+                std::cout << "  Skipped: aggregation data is uniform, sorted or recent" << std::endl;
+                continue;
+            }
+            allMatch &= runAggregationBenchmark(config, threads);
+        }
+        return allMatch ? 0 : 1;
+    }
+
+    if (config.sweepWorkingSet) {
+#if defined(__linux__) && defined(_SC_PHYS_PAGES)
+        const size_t physicalBytes = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (physicalBytes > 0 && config.sweepMaxBytes > physicalBytes / 2) {
+            config.sweepMaxBytes = physicalBytes / 2;
+        }
+#endif
+        const CacheSizes caches = CacheSizes::detect();
+        std::cout << "=== WORKING-SET SWEEP (years " << config.minYear << "-" << config.maxYear
+                  << ", sequential, up to " << (config.sweepMaxBytes >> 20) << " MB) ===" << std::endl;
+        if (caches.l1d > 0) {
+            std::cout << "Caches: L1d " << caches.l1d / 1024 << " KB, L2 " << caches.l2 / 1024 << " KB, L3 "
+                      << caches.l3 / 1024 << " KB" << std::endl;
+        }
+        const std::vector<SweepPoint> points = runWorkingSetSweep(config);
+        std::cout << std::endl;
+        printWorkingSetSweep(points, caches);
+        std::cout << "\nWriting results to working_set_sweep.csv..." << std::endl;
+        writeWorkingSetSweepCsv(points, caches, "working_set_sweep.csv");
+        return 0;
+    }
+
+    // Registered variants the filters select, the CPU can run and whose year
+    // range covers the years to be benchmarked or verified.
+    const int firstYear = config.verifyExhaustive ? config.verifyMinYear : config.minYear;
+    const int lastYear = config.verifyExhaustive ? config.verifyMaxYear : config.maxYear;
+    std::vector<const VariantInfo*> selected;
+    std::vector<const VariantInfo*> unsupported;
+    std::vector<const VariantInfo*> outOfRange;
+    for (const VariantInfo& v : variantRegistry()) {
+        if (!variantSelected(v, config)) {
+            continue;
+        }
+        if (!variantIsaSupported(v.isa)) {
+            unsupported.push_back(&v);
+        } else if (v.minYear > firstYear || v.maxYear < lastYear) {
+            outOfRange.push_back(&v);
+        } else {
+            selected.push_back(&v);
+        }
+    }
+    auto printOutOfRange = [&outOfRange] {
+        if (!outOfRange.empty()) {
+            std::cout << " (skipped, year range too narrow:";
+            for (const VariantInfo* v : outOfRange) {
+                std::cout << " " << v->name << " [" << v->minYear << "-" << v->maxYear << "]";
+            }
+            std::cout << ")";
+        }
+    };
+    if (selected.empty()) {
+        std::cerr << "No variants selected (see --list-variants)" << std::endl;
+        return 1;
+    }
+
+    std::vector<BaselineEntry> baseline;
+    if (!config.compareBaselinePath.empty() && !config.verifyExhaustive) {
+        const std::string error = loadBaseline(config.compareBaselinePath, baseline);
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (config.trialCount < COMPARE_MIN_TRIALS) {
+            std::cout << "--compare needs confidence intervals; running " << COMPARE_MIN_TRIALS
+                      << " trials instead of " << config.trialCount << std::endl;
+            config.trialCount = COMPARE_MIN_TRIALS;
+        }
+    }
+
+    if (config.verifyExhaustive) {
+        if (config.verifyMinYear < VERIFY_MIN_YEAR || config.verifyMaxYear > VERIFY_MAX_YEAR
+            || config.verifyMinYear > config.verifyMaxYear) {
+            std::cerr << "Verification range must be within " << VERIFY_MIN_YEAR << "-" << VERIFY_MAX_YEAR << std::endl;
+            return 1;
+        }
+        const size_t threads = config.threadCount > 1 ? config.threadCount
+                                                      : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<VerifyVariant> variants;
+        for (const VariantInfo* v : selected) {
+            if (v->verify) {
+                variants.push_back({v->name.c_str(), v->fullResult, v->verify});
+            }
+        }
+        if (!outOfRange.empty()) {
+            std::cout << "Variants";
+            printOutOfRange();
+            std::cout << std::endl;
+        }
+        const VerifyReport report = verifyExhaustive(config.verifyMinYear, config.verifyMaxYear, threads, std::move(variants));
+        printVerifyReport(report);
+        return report.passed() ? 0 : 1;
+    }
+
     std::cout << "=== ISO 8601 Week Date Conversion ===" << std::endl;
     std::cout << "Configuration:" << std::endl;
     std::cout << "  Test data size: " << config.testDataSize << std::endl;
     std::cout << "  Benchmark iterations: " << config.iterationCount << std::endl;
     std::cout << "  Year range: " << config.minYear << "-" << config.maxYear << std::endl;
+    std::cout << "  Threads: " << config.threadCount << std::endl;
+    std::cout << "  Distributions:";
+    for (const auto d : config.distributions) {
+        std::cout << " " << distributionName(d);
+    }
     std::cout << std::endl;
-
-    std::cout << "Generating test data..." << std::endl;
-    auto testData = generateTestData(config);
-    std::cout << "Generated " << testData.size() << " test cases" << std::endl;
+    std::cout << "  Variants: " << selected.size() << " of " << variantRegistry().size() << " registered";
+    if (!unsupported.empty()) {
+        std::cout << " (skipped, unsupported by this CPU:";
+        for (const VariantInfo* v : unsupported) {
+            std::cout << " " << v->name << " [" << variantIsaName(v->isa) << "]";
+        }
+        std::cout << ")";
+    }
+    printOutOfRange();
+    std::cout << std::endl;
+    std::cout << "  Hardware counters: " << PerfCounterGroup::describeAvailability(config.perfCounters) << std::endl;
+    std::cout << "  Trials: " << config.trialCount;
+    if (config.trialCount > 1) {
+        std::cout << " (random variant order, seed " << config.trialSeed << ", "
+                  << 100.0 * config.confidenceLevel << "% bootstrap intervals)";
+    }
     std::cout << std::endl;
+    {
+        CpuFrequencyInfo frequency;
+        frequency.capture();
+        std::cout << "  CPU frequency: " << frequency.describe() << std::endl;
+        for (const std::string& warning : frequency.warnings()) {
+            std::cout << "  Warning: " << warning << std::endl;
+        }
+    }
+    std::cout << "  Timing mode: " << timingModeName(config.timingMode);
+    if (config.timingMode == BenchmarkConfig::TimingMode::Batch) {
+        std::cout << " (" << config.timingBatchSize << " calls per sample)";
+    }
+    if (config.timingMode == BenchmarkConfig::TimingMode::Rdtsc && CycleTimer::available()) {
+        std::cout << " (TSC " << std::fixed << std::setprecision(3) << 1.0 / CycleTimer::nsPerTick() << " GHz)";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    {
+        const size_t tableBytes = sizeof(YEAR_INFO_TABLE);
+        std::cout << "V5 year table: " << YEAR_TABLE_FIRST << "-" << YEAR_TABLE_LAST << ", "
+                  << tableBytes << " bytes (" << (tableBytes + 63) / 64 << " cache lines)";
+        const long l1dBytes = CacheSizes::detect().l1d;
+        if (l1dBytes > 0) {
+            std::cout << ", " << std::setprecision(1) << std::fixed
+                      << (100.0 * tableBytes / l1dBytes) << "% of " << l1dBytes / 1024 << " KB L1d";
+            std::cout.unsetf(std::ios::floatfield);
+            std::cout << std::setprecision(6);
+        }
+        const int touchedFirst = std::max(config.minYear, YEAR_TABLE_FIRST);
+        const int touchedLast = std::min(config.maxYear, YEAR_TABLE_LAST);
+        if (touchedFirst <= touchedLast) {
+            std::cout << "; " << (touchedLast - touchedFirst) / 64 + 1 << " lines touched by the test range";
+        }
+        std::cout << std::endl << std::endl;
+    }
+
+    struct DistributionRun {
+        BenchmarkConfig::Distribution distribution;
+        std::vector<BenchmarkResult> results;
+    };
+    std::vector<DistributionRun> runs;
+    bool epochVerified = false;
+    bool reverseVerified = false;
+
+    for (const auto distribution : config.distributions) {
+        BenchmarkConfig runConfig = config;
+        runConfig.distribution = distribution;
+
+        std::cout << "Generating test data (" << distributionName(distribution) << ")..." << std::endl;
+        const auto generationStart = std::chrono::steady_clock::now();
+        auto testData = generateTestData(runConfig);
+        const double generationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - generationStart).count();
+        MemoryStats generationMemory;
+        generationMemory.capture();
+        std::cout << "Generated " << testData.size() << " test cases in " << std::fixed << std::setprecision(1)
+                  << generationMs << " ms (corpus " << testData.memoryBytes() / (1024.0 * 1024.0) << " MB, "
+                  << static_cast<double>(testData.memoryBytes()) / std::max<size_t>(1, testData.size()) << " bytes/case; RSS "
+                  << generationMemory.currentRssKb / 1024.0 << " MB)" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+        std::cout << std::endl;
 
-    std::cout << "Running benchmarks..." << std::endl;
+        std::cout << "Running benchmarks..." << std::endl;
+        runs.push_back({distribution, runVariants(selected, testData, runConfig, epochVerified, reverseVerified)});
+        std::cout << std::endl;
+    }
 
-    auto result_orig = benchmarkFunction("Original", convertGregorianDateToWeekDate_Original, testData, config);
-    auto result_v1 = benchmarkFunction("V1_EarlyReturn", convertGregorianDateToWeekDate_V1, testData, config);
-    auto result_v2 = benchmarkFunction("V2_BitOps_", convertGregorianDateToWeekDate_V2, testData, config);
-    auto result_v3 = benchmarkFunction("V3_Precalculation", convertGregorianDateToWeekDate_V3, testData, config);
+    const char* dispatchedKernel = nullptr;
+    selectBatchKernel(&dispatchedKernel);
 
     std::cout << "\n=== PERFORMANCE RESULTS ===" << std::endl;
     std::cout << std::fixed << std::setprecision(2);
@@ -511,9 +8208,64 @@ int main(int argc, char* argv[]) {
         std::cout << "    95th:      " << r.percentile95Ns << " ns" << std::endl;
         std::cout << "    99th:      " << r.percentile99Ns << " ns" << std::endl;
         std::cout << "    Speedup: " << (baseline_ns / r.averageTimeNs) << "x" << std::endl;
+        std::cout << "    Throughput: " << (r.throughputDatesPerSec / 1e6) << " Mdates/s";
+        if (r.inputBytesPerConversion) {
+            std::cout << ", " << (r.throughputDatesPerSec * r.inputBytesPerConversion / 1e6) << " MB/s of text";
+        }
+        std::cout << std::endl;
+        if (r.threadCount > 1) {
+            std::cout << "  Threads (" << r.threadCount << ", scaling efficiency "
+                      << (100.0 * r.scalingEfficiency) << "%):" << std::endl;
+            for (size_t t = 0; t < r.threadStats.size(); ++t) {
+                std::cout << "    #" << t << " cpu " << r.threadStats[t].cpu << ": "
+                          << (r.threadStats[t].throughputDatesPerSec / 1e6) << " Mdates/s" << std::endl;
+            }
+        }
+        if (r.perf.valid()) {
+            std::cout << "    Counters: " << r.perf.perConversion(PerfCounts::Cycles, r.iterations) << " cycles/conv";
+            if (r.perf.has(PerfCounts::Instructions)) {
+                std::cout << ", IPC " << r.perf.ipc();
+            }
+            if (r.perf.has(PerfCounts::Branches) && r.perf.has(PerfCounts::BranchMisses)) {
+                std::cout << ", branch-miss " << (100.0 * r.perf.branchMissRate()) << "%";
+            }
+            if (r.perf.has(PerfCounts::L1dMisses)) {
+                std::cout << ", " << r.perf.perConversion(PerfCounts::L1dMisses, r.iterations) << " L1d misses/conv";
+            }
+            if (r.perf.has(PerfCounts::Uops)) {
+                std::cout << ", " << r.perf.perConversion(PerfCounts::Uops, r.iterations) << " uops/conv";
+            }
+            std::cout << (r.perf.multiplexed ? " (multiplexed)" : "") << std::endl;
+        }
+        std::cout << "    Timing: " << r.timingMode << " (" << r.timerOverheadNs << " ns overhead subtracted), "
+                  << r.statsBackend << " statistics" << std::endl;
+        if (r.trials.count > 1) {
+            std::cout << "    Trials: " << r.trials.count << " (" << r.trials.rejected << " rejected), median ["
+                      << r.trials.median.low << ", " << r.trials.median.high << "] ns, mean ["
+                      << r.trials.mean.low << ", " << r.trials.mean.high << "] ns";
+            if (r.trials.maxMHz > r.trials.minMHz * 1.02) {
+                std::cout << "; clock varied " << r.trials.minMHz << "-" << r.trials.maxMHz << " MHz";
+            }
+            std::cout << std::endl;
+        }
+        if (r.tail.enabled() && r.tail.samples) {
+            // Each cause next to the share of all windows it occurred in.
+            std::cout << "  Tail (> " << r.tail.thresholdNs << " ns): " << r.tail.events.size() << " of "
+                      << r.tail.samples << " samples in " << r.tail.windows << " windows" << std::endl;
+            for (size_t c = 0; c < TAIL_CAUSES; ++c) {
+                if (r.tail.outliersByCause[c] || r.tail.windowsByCause[c]) {
+                    std::cout << "    " << std::left << std::setw(18) << tailCauseName(static_cast<TailCause>(c))
+                              << std::right << std::setw(8) << r.tail.outliersByCause[c] << " outliers, "
+                              << (100.0 * r.tail.windowsByCause[c] / r.tail.windows) << "% of windows" << std::endl;
+                }
+            }
+        }
 
         std::cout << "  Memory:" << std::endl;
         std::cout << "    Stack:      ~" << r.functionStackBytes << " bytes" << std::endl;
+        if (r.codeBytes) {
+            std::cout << "    Code:       " << r.codeBytes << " bytes" << std::endl;
+        }
         std::cout << "    RSS Before: " << r.memoryBefore.currentRssKb << " KB" << std::endl;
         std::cout << "    RSS After:  " << r.memoryAfter.currentRssKb << " KB" << std::endl;
         std::cout << "    Peak RSS:   " << r.memoryAfter.peakRssKb << " KB" << std::endl;
@@ -525,19 +8277,110 @@ int main(int argc, char* argv[]) {
         std::cout << std::endl;
     };
 
-    printResult(result_orig, result_orig.averageTimeNs);
-    printResult(result_v1, result_orig.averageTimeNs);
-    printResult(result_v2, result_orig.averageTimeNs);
-    printResult(result_v3, result_orig.averageTimeNs);
+    // Speedups are relative to Original, or to the first variant when it was filtered out.
+    auto baselineOf = [](const std::vector<BenchmarkResult>& results) {
+        double baselineNs = results.front().averageTimeNs;
+        for (const auto& r : results) {
+            if (r.versionName == "Original") {
+                baselineNs = r.averageTimeNs;
+            }
+        }
+        return baselineNs;
+    };
+    auto printOverhead = [](const auto& weekOnly, const auto& full) {
+        std::cout << "  " << std::left << std::setw(22) << full.versionName << std::right
+                  << weekOnly.averageTimeNs << " ns -> " << full.averageTimeNs << " ns ("
+                  << std::showpos << (100.0 * (full.averageTimeNs / weekOnly.averageTimeNs - 1.0))
+                  << std::noshowpos << "%)" << std::endl;
+    };
+
+    for (const DistributionRun& run : runs) {
+        const std::vector<BenchmarkResult>& results = run.results;
+        if (runs.size() > 1) {
+            std::cout << "\n=== DISTRIBUTION: " << distributionName(run.distribution) << " ===" << std::endl;
+        }
+        const double baselineNs = baselineOf(results);
+        for (const auto& r : results) {
+            printResult(r, baselineNs);
+        }
+
+        std::cout << "\n=== FULL RESULT OVERHEAD (ISO year + week + weekday vs week only) ===" << std::endl;
+        for (size_t k = 0; k < selected.size(); ++k) {
+            if (!selected[k]->weekOnlyPeer) {
+                continue;
+            }
+            for (const auto& weekOnly : results) {
+                if (weekOnly.versionName == selected[k]->weekOnlyPeer) {
+                    printOverhead(weekOnly, results[k]);
+                }
+            }
+        }
+    }
+    std::cout << "\nconvertWeekDates() dispatches to: " << dispatchedKernel << std::endl;
 
     std::cout << "\nWriting results to benchmark_analysis.csv..." << std::endl;
     std::ofstream csv("benchmark_analysis.csv");
-    csv << "Version,Average_ns,Median_ns,Min_ns,Max_ns,P95_ns,P99_ns,Speedup,"
+    csv << "Version,Distribution,Average_ns,Median_ns,Min_ns,Max_ns,P95_ns,P99_ns,Speedup,"
             << "Stack_Bytes,RSS_Before_KB,RSS_After_KB,Peak_RSS_KB,"
-            << "Iterations,Correctness,Discrepancies\n";
+            << "Iterations,Correctness,Discrepancies,Throughput_dates_per_s,"
+            << "Timing_Mode,Timer_Overhead_ns,Stats_Backend,Threads,Scaling_Efficiency,Kind,ISA,"
+            << "Cycles_per_conversion,Instructions_per_conversion,IPC,Branch_miss_rate,"
+            << "L1d_misses_per_conversion,Uops_per_conversion,Input_MB_per_s,Code_bytes,"
+            << "Trials,Trials_rejected,Median_CI_low_ns,Median_CI_high_ns,Mean_CI_low_ns,Mean_CI_high_ns\n";
+
+    // Per-thread rows go to a separate file in multithreaded runs.
+    std::ofstream threadCsv;
+    if (config.threadCount > 1) {
+        std::cout << "Writing per-thread results to benchmark_threads_analysis.csv..." << std::endl;
+        threadCsv.open("benchmark_threads_analysis.csv");
+        threadCsv << "Version,Distribution,Thread,CPU,Calls,Wall_ns,Throughput_dates_per_s,Scaling_Efficiency\n";
+    }
+
+    // One row per outlier sample, in time order within each run.
+    std::ofstream tailCsv;
+    if (config.tailThresholdNs > 0.0) {
+        std::cout << "Writing tail-latency timeline to tail_timeline.csv..." << std::endl;
+        tailCsv.open("tail_timeline.csv");
+        tailCsv << "Version,Distribution,Trial,Time_ms,Sample_ns,Thread,Window,CPU_before,CPU_after,"
+                << "Minor_faults,Major_faults,Voluntary_switches,Involuntary_switches,Cause\n";
+    }
+
+    auto writeCSV = [&csv, &threadCsv, &tailCsv](const VariantInfo& variant, const char* distribution,
+                                                 const BenchmarkResult& r, double baseline_ns) {
+        if (tailCsv.is_open()) {
+            for (const TailEvent& e : r.tail.events) {
+                tailCsv << r.versionName << ","
+                        << distribution << ","
+                        << e.trial << ","
+                        << e.timeMs << ","
+                        << e.sampleNs << ","
+                        << e.thread << ","
+                        << e.window << ","
+                        << e.cpuBefore << ","
+                        << e.cpuAfter << ","
+                        << e.minorFaults << ","
+                        << e.majorFaults << ","
+                        << e.voluntarySwitches << ","
+                        << e.involuntarySwitches << ","
+                        << tailCauseName(e.cause) << "\n";
+            }
+        }
+
+        if (threadCsv.is_open()) {
+            for (size_t t = 0; t < r.threadStats.size(); ++t) {
+                threadCsv << r.versionName << ","
+                          << distribution << ","
+                          << t << ","
+                          << r.threadStats[t].cpu << ","
+                          << r.threadStats[t].calls << ","
+                          << r.threadStats[t].wallNs << ","
+                          << r.threadStats[t].throughputDatesPerSec << ","
+                          << r.scalingEfficiency << "\n";
+            }
+        }
 
-    auto writeCSV = [&csv](const auto& r, double baseline_ns) {
         csv << r.versionName << ","
+            << distribution << ","
             << r.averageTimeNs << ","
             << r.medianTimeNs << ","
             << r.minTimeNs << ","
@@ -551,17 +8394,70 @@ int main(int argc, char* argv[]) {
             << r.memoryAfter.peakRssKb << ","
             << r.iterations << ","
             << (r.correctnessCheck ? "PASS" : "FAIL") << ","
-            << r.discrepancies << "\n";
+            << r.discrepancies << ","
+            << r.throughputDatesPerSec << ","
+            << r.timingMode << ","
+            << r.timerOverheadNs << ","
+            << r.statsBackend << ","
+            << r.threadCount << ","
+            << r.scalingEfficiency << ","
+            << variantKindName(variant.kind) << ","
+            << variantIsaName(variant.isa) << ",";
+
+        // Counter columns stay empty when the event was unavailable.
+        const PerfCounts& p = r.perf;
+        auto field = [&csv](bool present, double value, const char* separator) {
+            if (present) {
+                csv << value;
+            }
+            csv << separator;
+        };
+        field(p.has(PerfCounts::Cycles), p.perConversion(PerfCounts::Cycles, r.iterations), ",");
+        field(p.has(PerfCounts::Instructions), p.perConversion(PerfCounts::Instructions, r.iterations), ",");
+        field(p.has(PerfCounts::Cycles) && p.has(PerfCounts::Instructions), p.ipc(), ",");
+        field(p.has(PerfCounts::Branches) && p.has(PerfCounts::BranchMisses), p.branchMissRate(), ",");
+        field(p.has(PerfCounts::L1dMisses), p.perConversion(PerfCounts::L1dMisses, r.iterations), ",");
+        field(p.has(PerfCounts::Uops), p.perConversion(PerfCounts::Uops, r.iterations), ",");
+        field(r.inputBytesPerConversion != 0, r.throughputDatesPerSec * r.inputBytesPerConversion / 1e6, ",");
+        field(r.codeBytes != 0, static_cast<double>(r.codeBytes), ",");
+
+        csv << r.trials.count << ","
+            << r.trials.rejected << ","
+            << r.trials.median.low << ","
+            << r.trials.median.high << ","
+            << r.trials.mean.low << ","
+            << r.trials.mean.high << "\n";
     };
 
-    writeCSV(result_orig, result_orig.averageTimeNs);
-    writeCSV(result_v1, result_orig.averageTimeNs);
-    writeCSV(result_v2, result_orig.averageTimeNs);
-    writeCSV(result_v3, result_orig.averageTimeNs);
+    for (const DistributionRun& run : runs) {
+        const double baselineNs = baselineOf(run.results);
+        for (size_t k = 0; k < selected.size(); ++k) {
+            writeCSV(*selected[k], distributionName(run.distribution), run.results[k], baselineNs);
+        }
+    }
 
     csv.close();
 
+    size_t regressions = 0;
+    if (!baseline.empty()) {
+        // The results above left std::fixed set; the header wants "95%", not "95.00%".
+        std::ios format(nullptr);
+        format.copyfmt(std::cout);
+        std::cout << std::defaultfloat << "\n=== REGRESSION CHECK vs " << config.compareBaselinePath << " (median, "
+                  << 100.0 * config.confidenceLevel << "% interval, threshold " << 100.0 * config.regressionThreshold
+                  << "%) ===" << std::endl;
+        std::cout.copyfmt(format);
+        for (const DistributionRun& run : runs) {
+            if (runs.size() > 1) {
+                std::cout << " " << distributionName(run.distribution) << ":" << std::endl;
+            }
+            regressions += compareWithBaseline(baseline, distributionName(run.distribution), run.results, config);
+        }
+        std::cout << (regressions ? std::to_string(regressions) + " regression(s)" : std::string("No regressions"))
+                  << std::endl;
+    }
+
     std::cout << "\nDone!" << std::endl;
 
-    return 0;
+    return regressions ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,7 @@
+// All registered variants in one binary; filter with --only/--exclude.
+#include "version_original.cpp"
+#include "version_v1.cpp"
+#include "version_v2.cpp"
+#include "version_v4.cpp"
+#include "version_v5_table.cpp"
+#include "version_v6_mulshift.cpp"
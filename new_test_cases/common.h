@@ -8,6 +8,7 @@
 #include <cstring>
 #include <algorithm>
 #include <sstream>
+#include <string_view>
 #ifdef __linux__
 #include <sys/resource.h>
 #include <unistd.h>
@@ -107,3 +108,65 @@ void runBenchmark(const std::string& name, const std::string& opt_level, Func fu
               << times[static_cast<size_t>(times.size() * 0.95)] << ","
               << times[static_cast<size_t>(times.size() * 0.99)] << "\n";
 }
+#ifndef OPT_LEVEL
+#define OPT_LEVEL "Unknown"
+#endif
+// Each version_*.cpp registers its kernels with REGISTER_VARIANT; main() below
+// runs every registered variant, filtered by --only/--exclude (comma-separated
+// globs, '*' wildcard).
+struct VariantInfo {
+    const char* name;
+    void (*run)(const char* name, const std::vector<TestCase>& testData, const BenchmarkConfig& config);
+};
+inline std::vector<VariantInfo>& variantRegistry() {
+    static std::vector<VariantInfo> registry;
+    return registry;
+}
+struct VariantRegistrar {
+    VariantRegistrar(const char* name, void (*run)(const char*, const std::vector<TestCase>&, const BenchmarkConfig&)) {
+        variantRegistry().push_back({name, run});
+    }
+};
+template<auto Func>
+void runRegistered(const char* name, const std::vector<TestCase>& testData, const BenchmarkConfig& config) {
+    runBenchmark(name, OPT_LEVEL, Func, testData, config);
+}
+#define VARIANT_CONCAT_IMPL(a, b) a##b
+#define VARIANT_CONCAT(a, b) VARIANT_CONCAT_IMPL(a, b)
+#define REGISTER_VARIANT(name, func) \
+    static const VariantRegistrar VARIANT_CONCAT(variantRegistrar_, __COUNTER__)(name, runRegistered<func>)
+inline bool globMatch(std::string_view pattern, std::string_view name) {
+    size_t p = 0, n = 0, star = std::string_view::npos, resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') { star = p++; resume = n; }
+        else if (p < pattern.size() && pattern[p] == name[n]) { ++p; ++n; }
+        else if (star != std::string_view::npos) { p = star + 1; n = ++resume; }
+        else return false;
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+inline bool matchesAnyPattern(std::string_view patterns, std::string_view name) {
+    while (!patterns.empty()) {
+        const size_t comma = patterns.find(',');
+        if (globMatch(patterns.substr(0, comma), name)) return true;
+        patterns = comma == std::string_view::npos ? std::string_view() : patterns.substr(comma + 1);
+    }
+    return false;
+}
+int main(int argc, char* argv[]) {
+    std::string only, exclude;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--only") only = argv[++i];
+        else if (arg == "--exclude") exclude = argv[++i];
+    }
+    BenchmarkConfig config;
+    std::vector<TestCase> testData;
+    for (const VariantInfo& v : variantRegistry()) {
+        if ((!only.empty() && !matchesAnyPattern(only, v.name)) || matchesAnyPattern(exclude, v.name)) continue;
+        if (testData.empty()) testData = generateTestData(config);
+        v.run(v.name, testData, config);
+    }
+    return 0;
+}
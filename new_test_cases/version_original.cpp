@@ -27,12 +27,4 @@ int convertGregorianDateToWeekDate_Original(const struct tm& times) noexcept {
     }
     return weekNumber;
 }
-#ifndef OPT_LEVEL
-#define OPT_LEVEL "Unknown"
-#endif
-int main() {
-    BenchmarkConfig config;
-    auto testData = generateTestData(config);
-    runBenchmark("Original", OPT_LEVEL, convertGregorianDateToWeekDate_Original, testData, config);
-    return 0;
-}
+REGISTER_VARIANT("Original", convertGregorianDateToWeekDate_Original);
@@ -19,12 +19,4 @@ int convertGregorianDateToWeekDate_V1(const struct tm& times) noexcept {
     if (jan1Weekday > 4) weekNumber--;
     return weekNumber;
 }
-#ifndef OPT_LEVEL
-#define OPT_LEVEL "Unknown"
-#endif
-int main() {
-    BenchmarkConfig config;
-    auto testData = generateTestData(config);
-    runBenchmark("V1_EarlyReturn", OPT_LEVEL, convertGregorianDateToWeekDate_V1, testData, config);
-    return 0;
-}
+REGISTER_VARIANT("V1_EarlyReturn", convertGregorianDateToWeekDate_V1);
@@ -19,12 +19,4 @@ int convertGregorianDateToWeekDate_V2(const struct tm& times) noexcept {
     const int weekNumber = (j / 7) - (jan1Weekday > 4);
     return weekNumber;
 }
-#ifndef OPT_LEVEL
-#define OPT_LEVEL "Unknown"
-#endif
-int main() {
-    BenchmarkConfig config;
-    auto testData = generateTestData(config);
-    runBenchmark("V2_BitOps", OPT_LEVEL, convertGregorianDateToWeekDate_V2, testData, config);
-    return 0;
-}
+REGISTER_VARIANT("V2_BitOps", convertGregorianDateToWeekDate_V2);
@@ -17,12 +17,4 @@ int convertGregorianDateToWeekDate_V4_Mask(const struct tm& times) noexcept
     const int currYearWeek = (j / 7) - (jan1Weekday > 4);
     return (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
 }
-#ifndef OPT_LEVEL
-#define OPT_LEVEL "Unknown"
-#endif
-int main() {
-    BenchmarkConfig config;
-    auto testData = generateTestData(config);
-    runBenchmark("V4_MathMask", OPT_LEVEL, convertGregorianDateToWeekDate_V4_Mask, testData, config);
-    return 0;
-}
+REGISTER_VARIANT("V4_MathMask", convertGregorianDateToWeekDate_V4_Mask);
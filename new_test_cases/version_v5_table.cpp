@@ -0,0 +1,44 @@
+#include "common.h"
+#include <array>
+#include <cstdint>
+constexpr int YEAR_TABLE_FIRST = 1600;
+constexpr int YEAR_TABLE_LAST = 3199;
+constexpr uint8_t yearInfoEntry(int y) noexcept
+{
+    const int y_1 = y - 1;
+    const int jan1Weekday = 1 + ((y_1 + (y_1 / 4) - (y_1 / 100) + (y_1 / 400)) % 7);
+    const int isLeap = ((y & 3) == 0) & (((y % 100) != 0) | ((y % 400) == 0));
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 % 100) != 0) | ((y_1 % 400) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    return static_cast<uint8_t>(jan1Weekday | (isLeap << 3) | (prevIs53 << 4));
+}
+constexpr std::array<uint8_t, YEAR_TABLE_LAST - YEAR_TABLE_FIRST + 1> buildYearInfoTable() noexcept
+{
+    std::array<uint8_t, YEAR_TABLE_LAST - YEAR_TABLE_FIRST + 1> table{};
+    for (int y = YEAR_TABLE_FIRST; y <= YEAR_TABLE_LAST; ++y) table[y - YEAR_TABLE_FIRST] = yearInfoEntry(y);
+    return table;
+}
+alignas(64) constexpr auto YEAR_INFO_TABLE = buildYearInfoTable();
+int convertGregorianDateToWeekDate_V5_Table(const struct tm& times) noexcept
+{
+    const int y = times.tm_year + 1900;
+    const int dayOfYear = times.tm_yday + 1;
+    const unsigned index = static_cast<unsigned>(y - YEAR_TABLE_FIRST);
+    const unsigned info = index < YEAR_INFO_TABLE.size() ? YEAR_INFO_TABLE[index] : yearInfoEntry(y);
+    const unsigned jan1Offset = (info & 7) - 1;
+    const unsigned t = static_cast<unsigned>(dayOfYear - 1) + jan1Offset;
+    const int weekday = 1 + static_cast<int>(t % 7);
+    const int currYearWeek = static_cast<int>(t / 7) + 1 - (jan1Offset >= 4);
+    const int isPrevYear = currYearWeek == 0;
+    const int prevYearWeek = 52 + static_cast<int>((info >> 4) & 1);
+    const int daysInYear = 365 + static_cast<int>((info >> 3) & 1);
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    return (isPrevYear * prevYearWeek) + isNextYear + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
+void runV5Table(const char* name, const std::vector<TestCase>& testData, const BenchmarkConfig& config) {
+    std::cerr << "V5_YearTable footprint: " << sizeof(YEAR_INFO_TABLE) << " bytes, "
+              << (sizeof(YEAR_INFO_TABLE) + 31) / 32 << " x 32-byte L1 lines (i586), "
+              << (config.maxYear - config.minYear) / 32 + 1 << " lines touched by the test range\n";
+    runBenchmark(name, OPT_LEVEL, convertGregorianDateToWeekDate_V5_Table, testData, config);
+}
+static const VariantRegistrar v5TableRegistrar("V5_YearTable", runV5Table);
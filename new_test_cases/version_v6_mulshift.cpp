@@ -0,0 +1,29 @@
+#include "common.h"
+// Every /7, %7, /100, %100, /400, %400 of V4 as a 32-bit multiply-shift:
+// x / 7 = (x * 18725) >> 17 (x <= 43692), x / 100 = (x * 5243) >> 19 (x <= 43698).
+// Valid for years 1-32767 (checked by main.cpp --verify-exhaustive).
+static inline unsigned div7_MulShift(unsigned x) noexcept { return (x * 18725u) >> 17; }
+static inline unsigned div100_MulShift(unsigned x) noexcept { return (x * 5243u) >> 19; }
+int convertGregorianDateToWeekDate_V6_MulShift(const struct tm& times) noexcept
+{
+    const int dayOfYear = times.tm_yday + 1;
+    const unsigned uy = static_cast<unsigned>(times.tm_year + 1900);
+    const unsigned y_1 = uy - 1;
+    const unsigned q100_1 = div100_MulShift(y_1);
+    const unsigned sum = y_1 + (y_1 >> 2) - q100_1 + (q100_1 >> 2);
+    const int jan1Weekday = 1 + static_cast<int>(sum - 7 * div7_MulShift(sum));
+    const unsigned t = static_cast<unsigned>(dayOfYear + jan1Weekday - 2);
+    const int weekday = 1 + static_cast<int>(t - 7 * div7_MulShift(t));
+    const int isPrevYear = (dayOfYear <= (8 - jan1Weekday)) & (jan1Weekday > 4);
+    const int prevYearLeap = ((y_1 & 3) == 0) & (((y_1 - 100 * q100_1) != 0) | ((q100_1 & 3) == 0));
+    const int prevIs53 = (jan1Weekday == 5) | ((jan1Weekday == 6) & prevYearLeap);
+    const int prevYearWeek = 52 + prevIs53;
+    const unsigned q100 = div100_MulShift(uy);
+    const int isLeap = ((uy & 3) == 0) & (((uy - 100 * q100) != 0) | ((q100 & 3) == 0));
+    const int daysInYear = 365 + isLeap;
+    const int isNextYear = (daysInYear - dayOfYear) < (4 - weekday);
+    const unsigned j = static_cast<unsigned>(dayOfYear + (7 - weekday) + (jan1Weekday - 1));
+    const int currYearWeek = static_cast<int>(div7_MulShift(j)) - (jan1Weekday > 4);
+    return (isPrevYear * prevYearWeek) + (isNextYear * 1) + (((isPrevYear | isNextYear) ^ 1) * currYearWeek);
+}
+REGISTER_VARIANT("V6_MulShift", convertGregorianDateToWeekDate_V6_MulShift);